@@ -276,11 +276,17 @@ static void MX_GPIO_Init(void)
   GPIO_InitStruct.Pull = GPIO_NOPULL;
   HAL_GPIO_Init(B1_GPIO_Port, &GPIO_InitStruct);
 
-  /*Configure GPIO pins : SW_DESACTIVAR_Pin SW_BARRERA_Pin */
-  GPIO_InitStruct.Pin = SW_DESACTIVAR_Pin|SW_BARRERA_Pin;
+  /*Configure GPIO pin : SW_DESACTIVAR_Pin */
+  GPIO_InitStruct.Pin = SW_DESACTIVAR_Pin;
+  GPIO_InitStruct.Mode = GPIO_MODE_IT_FALLING;
+  GPIO_InitStruct.Pull = GPIO_PULLUP;
+  HAL_GPIO_Init(SW_DESACTIVAR_GPIO_Port, &GPIO_InitStruct);
+
+  /*Configure GPIO pin : SW_BARRERA_Pin */
+  GPIO_InitStruct.Pin = SW_BARRERA_Pin;
   GPIO_InitStruct.Mode = GPIO_MODE_INPUT;
   GPIO_InitStruct.Pull = GPIO_PULLUP;
-  HAL_GPIO_Init(GPIOC, &GPIO_InitStruct);
+  HAL_GPIO_Init(SW_BARRERA_GPIO_Port, &GPIO_InitStruct);
 
   /*Configure GPIO pins : BTN_INGRESO_Pin BTN_EGRESO_Pin BTN_MODE_Pin */
   GPIO_InitStruct.Pin = BTN_INGRESO_Pin|BTN_EGRESO_Pin|BTN_MODE_Pin;
@@ -336,6 +342,9 @@ static void MX_GPIO_Init(void)
   HAL_GPIO_Init(GPIOB, &GPIO_InitStruct);
 
   /* EXTI interrupt init*/
+  HAL_NVIC_SetPriority(EXTI0_IRQn, 0, 0);
+  HAL_NVIC_EnableIRQ(EXTI0_IRQn);
+
   HAL_NVIC_SetPriority(EXTI15_10_IRQn, 0, 0);
   HAL_NVIC_EnableIRQ(EXTI15_10_IRQn);
 
@@ -53,16 +53,39 @@ extern "C" {
 #define TEST_X (TEST_0)
 
 /********************** typedef **********************************************/
+/* Boot milestones, measured from reset (see app_boot_mark()) */
+typedef enum {
+	APP_BOOT_SENSOR,				// First task_sensor_update(): inputs are being read
+	APP_BOOT_DISPLAY,				// LCD initialized and showing the splash
+	APP_BOOT_QTY
+} app_boot_mark_t;
+
+/* Capture time (see app_stamp()): input edges and output writes */
+typedef struct
+{
+	uint32_t	tick;				// g_app_tick_cnt
+	uint32_t	cyc;				// CYCCNT, latencies are differences of it
+} app_stamp_t;
 
 /********************** external data declaration ****************************/
 extern uint32_t g_app_cnt;
 extern uint32_t g_app_time_us;
 
+/* Free-running tick (1 mS), only written by HAL_SYSTICK_Callback().
+ * Tasks read it without locking and keep their own last processed tick. */
 extern volatile uint32_t g_app_tick_cnt;
 
+/* CYCCNT on entry to EXTI0_IRQHandler() (SW_DESACTIVAR edge): start of the
+ * fast-stop latency, before the HAL dispatch */
+extern volatile uint32_t g_app_exti0_cyc;
+
 /********************** external functions declaration ***********************/
 void app_init(void);
 void app_update(void);
+void app_fg_update(void);
+void app_log_profile(void);
+void app_boot_mark(app_boot_mark_t mark);
+void app_stamp(app_stamp_t *p_stamp);
 
 /********************** End of CPP guard *************************************/
 #ifdef __cplusplus
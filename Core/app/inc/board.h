@@ -77,6 +77,43 @@
 #define LCD_D7_PORT     GPIOC
 #define LCD_D7_PIN      GPIO_PIN_8
 
+/* D0..D3: solo con DISPLAY_CONNECTION_GPIO_8BITS (en 4 bits quedan libres).
+ * No están en CubeMX, los configura displayInit(). Tienen que estar en el
+ * puerto de D4 o en el de D7 (un store a BSRR por puerto y por byte) */
+#define LCD_D0_PORT     GPIOC
+#define LCD_D0_PIN      GPIO_PIN_10
+
+#define LCD_D1_PORT     GPIOC
+#define LCD_D1_PIN      GPIO_PIN_11
+
+#define LCD_D2_PORT     GPIOC
+#define LCD_D2_PIN      GPIO_PIN_12
+
+#define LCD_D3_PORT     GPIOB
+#define LCD_D3_PIN      GPIO_PIN_8
+
+/* RW: solo con DISPLAY_CFG_BUSY_FLAG = 1 (si no, RW va a GND). En la lectura
+ * de BF el HD44780 pone 5 V en D4..D7 y, con el bus de 8 bits, también en
+ * D0..D3: todos tienen que ser pines 5V tolerant (FT). D4..D7 (PB14, PB15,
+ * PC6, PC8) y D0..D3 (PC10..PC12, PB8) lo son; PA0..PA7, PB0, PB1, PB5,
+ * PC0..PC5 y PC13..PC15 no (entradas analógicas / dominio de backup) */
+#define LCD_RW_PORT     GPIOC
+#define LCD_RW_PIN      GPIO_PIN_9
+
+/* LCD con backpack PCF8574 (DISPLAY_CONNECTION_I2C): I2C2 en PB10/PB11, con
+ * las pull-ups del módulo. El PCF8574 maneja RS/RW/EN/luz de fondo y D4..D7 */
+#define LCD_I2C_SCL_PORT    GPIOB
+#define LCD_I2C_SCL_PIN     GPIO_PIN_10
+#define LCD_I2C_SDA_PORT    GPIOB
+#define LCD_I2C_SDA_PIN     GPIO_PIN_11
+
+#define LCD_I2C_ADDR        0x27    // 7 bits, A2..A0 = 1 (PCF8574A: 0x3F)
+#define LCD_I2C_BIT_RS      0x01    // P0
+#define LCD_I2C_BIT_RW      0x02    // P1 (siempre 0: solo escritura)
+#define LCD_I2C_BIT_EN      0x04    // P2
+#define LCD_I2C_BIT_BL      0x08    // P3, luz de fondo
+#define LCD_I2C_DATA_SHIFT  4       // D4..D7 en P4..P7
+
 /* --- SALIDAS (Actuadores / LEDs - Active High) --- */
 
 #define LED_MOTOR_MAX_PORT   LED_MOTOR_MAX_GPIO_Port
@@ -6,14 +6,16 @@ extern "C" {
 #endif
 
 #include <stdint.h>
+#include <stdbool.h>
 
 /* --- TIPOS DE DATOS --- */
 
 // Tipos de conexión soportados
 typedef enum {
     DISPLAY_CONNECTION_GPIO_4BITS,
-    DISPLAY_CONNECTION_GPIO_8BITS,
-    DISPLAY_CONNECTION_I2C
+    DISPLAY_CONNECTION_GPIO_4BITS_DMA,  // Mismos pines, cuadros enviados por TIM2 + DMA1
+    DISPLAY_CONNECTION_GPIO_8BITS,      // D0..D7 (board.h): un solo pulso de EN por byte
+    DISPLAY_CONNECTION_I2C              // Backpack PCF8574 por I2C2 + DMA1 (board.h)
 } displayConnection_t;
 
 // Identificadores internos de pines del LCD
@@ -32,28 +34,74 @@ typedef enum {
     DISPLAY_PIN_D7
 } displayPin_t;
 
+// Código de carácter de un glifo CGRAM: 0x08..0x0F son alias de 0x00..0x07,
+// así el glifo 0 no termina la cadena
+#define DISPLAY_CGRAM_CHAR(index)   ((char)(0x08 + ((index) & 0x07)))
+
 /* --- PROTOTIPOS DE FUNCIONES PÚBLICAS --- */
 
 /**
  * @brief  Inicializa el display LCD 16x2.
  * Configura los pines definidos en board.h y ejecuta la secuencia de arranque.
- * @param  connection: Tipo de conexión (Usar DISPLAY_CONNECTION_GPIO_4BITS)
+ * @param  connection: DISPLAY_CONNECTION_GPIO_4BITS (la CPU escribe el bus),
+ *         DISPLAY_CONNECTION_GPIO_4BITS_DMA (TIM2 + DMA1 escriben el bus),
+ *         DISPLAY_CONNECTION_GPIO_8BITS (la CPU escribe el byte entero) o
+ *         DISPLAY_CONNECTION_I2C (PCF8574 por I2C2 + DMA1)
  */
 void displayInit(displayConnection_t connection);
 
 /**
- * @brief  Mueve el cursor a una posición específica.
+ * @brief  Mueve el cursor del framebuffer a una posición específica.
  * @param  x: Columna (0 a 15)
  * @param  y: Fila (0 o 1)
  */
 void displayCharPositionWrite(uint8_t x, uint8_t y);
 
 /**
- * @brief  Escribe una cadena de texto en la posición actual del cursor.
+ * @brief  Escribe una cadena en el framebuffer desde la posición del cursor (no
+ * bloquea, se recorta en la columna 16). Solo se envían las celdas que cambian.
  * @param  str: Puntero a la cadena (terminada en \0)
  */
 void displayStringWrite(const char * str);
 
+/**
+ * @brief  Carga un glifo 5x8 en CGRAM (no bloquea, se envía con la cola). El
+ * glifo se escribe en el framebuffer con DISPLAY_CGRAM_CHAR(index).
+ * @param  index: Glifo (0 a 7)
+ * @param  pattern: 8 filas, 5 bits cada una (bit 4 = columna izquierda)
+ * @retval false si la cola no tiene lugar para los 9 códigos
+ */
+bool displayGlyphDefine(uint8_t index, const uint8_t *pattern);
+
+/**
+ * @brief  Avanza el motor asíncrono: envía los nibbles encolados respetando los
+ * tiempos del HD44780, sin esperar el tiempo de ejecución de cada comando.
+ * Llamar periódicamente (tarea display, 1 ms).
+ */
+void displayUpdate(void);
+
+/**
+ * @brief  Indica si el cuadro encolado ya terminó de enviarse.
+ * @retval true si la cola está vacía y el último comando terminó de ejecutarse
+ */
+bool displayFrameDone(void);
+
+/**
+ * @brief  Envía todo lo encolado esperando activamente. Lo usa la prueba
+ *         bloqueante test_lcd_boca_juniors(); el firmware no lo llama.
+ */
+void displayFlush(void);
+
+/**
+ * @brief  Imprime la cola del LCD y los bytes enviados por cuadro.
+ */
+void displayLogStats(void);
+
+// Backend DISPLAY_CONNECTION_I2C: I2C2_EV_IRQHandler() / I2C2_ER_IRQHandler()
+void displayI2cEventIrq(void);
+
+void displayI2cErrorIrq(void);
+
 #ifdef __cplusplus
 }
 #endif
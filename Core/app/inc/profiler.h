@@ -0,0 +1,59 @@
+/*
+ * profiler.h
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#ifndef APP_INC_PROFILER_H_
+#define APP_INC_PROFILER_H_
+
+/********************** CPP guard ********************************************/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/********************** inclusions *******************************************/
+#include <stdint.h>
+
+#include "dwt.h"
+
+/********************** macros ***********************************************/
+/* Log2 histogram: bucket 0 holds samples < 2^(PROFILER_HIST_SHIFT + 1) cycles,
+ * bucket i holds [2^(i + PROFILER_HIST_SHIFT), 2^(i + PROFILER_HIST_SHIFT + 1))
+ * and the last bucket everything above */
+#define PROFILER_HIST_QTY		(16)
+#define PROFILER_HIST_SHIFT		(6)
+
+/* Start a measurement: CYCCNT is free-running, it is never reset */
+#define profiler_start()		(cycle_counter_get())
+
+/********************** typedef **********************************************/
+typedef struct
+{
+	uint32_t	cnt;						// Samples
+	uint32_t	min;						// Minimum (cycles)
+	uint32_t	max;						// Maximum (cycles)
+	uint32_t	last;						// Last sample (cycles)
+	uint64_t	sum;						// Sum of samples (cycles)
+	uint32_t	hist[PROFILER_HIST_QTY];	// Log2 histogram
+} profiler_dta_t;
+
+/********************** external data declaration ****************************/
+extern uint32_t g_profiler_overhead;		// Measurement overhead (cycles)
+
+/********************** external functions declaration ***********************/
+void profiler_init(void);
+void profiler_reset(profiler_dta_t *p_dta);
+uint32_t profiler_stop(profiler_dta_t *p_dta, uint32_t start);
+void profiler_add(profiler_dta_t *p_dta, uint32_t cycles);
+uint32_t profiler_mean(const profiler_dta_t *p_dta);
+void profiler_log(const char *name, const profiler_dta_t *p_dta);
+
+/********************** End of CPP guard *************************************/
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* APP_INC_PROFILER_H_ */
+
+/********************** end of file ******************************************/
@@ -0,0 +1,56 @@
+/*
+ * ring_buffer.h
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#ifndef APP_INC_RING_BUFFER_H_
+#define APP_INC_RING_BUFFER_H_
+
+/********************** CPP guard ********************************************/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/********************** inclusions *******************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/********************** macros ***********************************************/
+/* Single-producer/single-consumer, lock-free: head is written only by the
+ * producer and tail only by the consumer, so put() may run in an ISR and get()
+ * in a task (or the other way around) without disabling interrupts.
+ * head/tail are free-running: head - tail is the fill level, also across the
+ * 32-bit wrap-around, and the slot index is (index & (size - 1)). */
+#define RING_BUFFER_IS_POW2(size)	((0 != (size)) && (0 == ((size) & ((size) - 1))))
+
+/********************** typedef **********************************************/
+typedef struct
+{
+	uint8_t *			p_buffer;		// size * item_size bytes
+	uint32_t			size;			// Items, power of 2
+	uint32_t			item_size;		// Bytes per item
+	volatile uint32_t	head;			// Free-running, producer only
+	volatile uint32_t	tail;			// Free-running, consumer only
+	uint32_t			overflow_cnt;	// Items dropped on a full buffer (producer)
+	uint32_t			high_watermark;	// Max items pending (producer)
+} ring_buffer_t;
+
+/********************** external data declaration ****************************/
+
+/********************** external functions declaration ***********************/
+bool ring_buffer_init(ring_buffer_t *p_rb, void *p_buffer, uint32_t size, uint32_t item_size);
+bool ring_buffer_put(ring_buffer_t *p_rb, const void *p_item);
+bool ring_buffer_get(ring_buffer_t *p_rb, void *p_item);
+bool ring_buffer_is_empty(const ring_buffer_t *p_rb);
+uint32_t ring_buffer_count(const ring_buffer_t *p_rb);
+void ring_buffer_log(const char *name, const ring_buffer_t *p_rb);
+
+/********************** End of CPP guard *************************************/
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* APP_INC_RING_BUFFER_H_ */
+
+/********************** end of file ******************************************/
@@ -44,6 +44,7 @@ extern "C" {
 #endif
 
 /********************** inclusions *******************************************/
+#include "profiler.h"
 
 /********************** macros ***********************************************/
 
@@ -51,11 +52,14 @@ extern "C" {
 
 /********************** external data declaration ****************************/
 extern uint32_t g_task_actuator_cnt;
-extern volatile uint32_t g_task_actuator_tick_cnt;
+extern uint32_t g_task_actuator_last_tick;
+extern volatile bool g_task_actuator_safety_latch;
+extern profiler_dta_t g_task_actuator_safety_profile;	// Flanco EXTI -> motores apagados
 
 /********************** external functions declaration ***********************/
 extern void task_actuator_init(void *parameters);
 extern void task_actuator_update(void *parameters);
+extern void task_actuator_log_latency(void);
 
 /********************** End of CPP guard *************************************/
 #ifdef __cplusplus
@@ -140,6 +140,7 @@ typedef struct
 	GPIO_PinState		off_state;
 	uint32_t			tick_blink;
 	uint32_t			tick_pulse;
+	bool				safety_stop;	// Apagado por la parada rápida (EXTI)
 } task_actuator_cfg_t;
 
 typedef struct
@@ -148,6 +149,10 @@ typedef struct
 	task_actuator_st_t	state;
 	task_actuator_ev_t	event;
 	bool				flag;
+	task_system_ev_t	cause;			// Input event behind event (latency trace)
+	app_stamp_t			edge;			// Capture time of its input edge
+	bool				trace;			// Edge not yet matched with a write
+	app_stamp_t			out;			// Last GPIO write
 } task_actuator_dta_t;
 
 /********************** external data declaration ****************************/
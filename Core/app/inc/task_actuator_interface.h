@@ -54,6 +54,16 @@ extern "C" {
 /********************** external functions declaration ***********************/
 extern void put_event_task_actuator(task_actuator_ev_t event, task_actuator_id_t identifier);
 
+/* Input event behind the next put_event_task_actuator() calls (NULL: none) */
+extern void cause_event_task_actuator(task_system_ev_t cause, const app_stamp_t *p_stamp);
+
+/* Parada rápida: apaga los motores desde el EXTI de SW_DESACTIVAR (contexto ISR);
+ * start = CYCCNT a la entrada del handler, inicio de la latencia medida */
+extern void safety_stop_task_actuator(uint32_t start);
+
+/* Libera la parada rápida si el switch ya no está activo y restaura las salidas */
+extern void safety_release_task_actuator(void);
+
 /********************** End of CPP guard *************************************/
 #ifdef __cplusplus
 }
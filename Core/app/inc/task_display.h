@@ -36,6 +36,12 @@ extern void task_display_init(void *parameters);
  */
 extern void task_display_update(void *parameters);
 
+/**
+ * @brief  Imprime cuadros por segundo y pedidos de refresco fusionados desde
+ * el último reporte.
+ */
+extern void task_display_log_stats(void);
+
 /********************** End of CPP guard *************************************/
 #ifdef __cplusplus
 }
@@ -33,11 +33,26 @@ typedef enum {
 } task_display_ev_t;
 
 
+// Cuadros dibujados y pedidos de refresco fusionados
+typedef struct {
+    uint32_t          requests;             // Llamadas a Display_*()
+    uint32_t          merged;               // Pedidos que encontraron otro pendiente
+    uint32_t          frames;               // Cuadros dibujados
+    uint32_t          deferred;             // Cuadros retrasados por el límite (uno por cuadro)
+    uint32_t          window_frames;        // Cuadros desde el último reporte
+    uint32_t          window_tick;          // HAL_GetTick() del último reporte
+} task_display_stats_t;
+
 typedef struct {
 
     task_display_st_t state;
     task_display_ev_t event;
-    bool              flag;
+    bool              flag;                 // Modelo cambiado desde el último cuadro
+    uint32_t          frame_tick;           // HAL_GetTick() del último cuadro
+    bool              frame_held;           // Cuadro pendiente ya contado en stats.deferred
+    bool              splash_drawn;         // Bienvenida ya encolada (ST_DSP_INIT)
+    uint32_t          splash_tick;          // HAL_GetTick() de la bienvenida
+    task_display_stats_t stats;
 
     // Buffer de Datos
     char              system_state_str[10]; // Ej: "RUN", "IDLE", "EMER"
@@ -51,12 +51,16 @@ extern "C" {
 
 /********************** external data declaration ****************************/
 extern uint32_t g_task_sensor_cnt;
-extern volatile uint32_t g_task_sensor_tick_cnt;
+extern uint32_t g_task_sensor_last_tick;
 
 /********************** external functions declaration ***********************/
 void task_sensor_init(void *parameters);
 void task_sensor_update(void *parameters);
 
+/* EXTI edge on a sensor line (ISR context, from HAL_GPIO_EXTI_Callback()) */
+void task_sensor_exti(uint16_t GPIO_Pin);
+void task_sensor_log_stats(void);
+
 /********************** End of CPP guard *************************************/
 #ifdef __cplusplus
 }
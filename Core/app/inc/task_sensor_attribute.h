@@ -46,51 +46,40 @@ extern "C" {
 /********************** inclusions *******************************************/
 #include "task_system_attribute.h"
 /********************** macros ***********************************************/
+#define TASK_SENSOR_CNT_BITS	6ul		// Debounce counters up to 63 samples
+#define TASK_SENSOR_QTY_MAX		32ul	// One bit per input
 
 /********************** typedef **********************************************/
-/* Sensor Statechart - State Transition Table */
-/* 	------------------------+-----------------------+-----------------------+-----------------------+------------------------
- * 	| Current               | Event                 |                       | Next                  |                       |
- * 	| State                 | (Parameters)          | [Guard]               | State                 | Actions               |
- * 	|=======================+=======================+=======================+=======================+=======================|
- * 	| ST_BTN_XX_UP          | EV_BTN_XX_UP          |                       | ST_BTN_XX_UP          |                       |
- * 	|                       +-----------------------+-----------------------+-----------------------+-----------------------|
- * 	|                       | EV_BTN_XX_DOWN        |                       | ST_BTN_XX_FALLING     | tick = TICK_MAX       |
- * 	|-----------------------+-----------------------+-----------------------+-----------------------+-----------------------|
- * 	| ST_BTN_XX_FALLING     | EV_BTN_XX_UP          | [tick >  0]           | ST_BTN_XX_FALLING     | tick--                |
- * 	|                       |                       +-----------------------+-----------------------+-----------------------|
- * 	|                       |                       | [tick == 0]           | ST_BTN_XX_UP          |                       |
- * 	|                       +-----------------------+-----------------------+-----------------------+-----------------------|
- * 	|                       | EV_BTN_XX_DOWN        | [tick >  0]           | ST_BTN_XX_FALLING     | tick--                |
- * 	|                       |                       +-----------------------+-----------------------+-----------------------|
- * 	|                       |                       | [tick == 0]           | ST_BTN_XX_DOWN        | put_event_task_system |
- * 	|                       |                       |                       |                       |  (event)              |
- * 	|-----------------------+-----------------------+-----------------------+-----------------------+-----------------------|
- *	| ST_BTN_XX_DOWN        | EV_BTN_XX_UP          |                       | ST_BTN_XX_RISING      | tick = TICK_MAX       |
- * 	|                       +-----------------------+-----------------------+-----------------------+-----------------------|
- * 	|                       | EV_BTN_XX_DOWN        |                       | ST_BTN_XX_DOWN        |                       |
- * 	|-----------------------+-----------------------+-----------------------+-----------------------+-----------------------|
- * 	| ST_BTN_XX_RISING      | EV_BTN_XX_UP          | [tick >  0]           | ST_BTN_XX_RISING      | tick--                |
- * 	|                       |                       +-----------------------+-----------------------+-----------------------|
- * 	|                       |                       | [tick == 0]           | ST_BTN_XX_UP          | put_event_task_system |
- * 	|                       |                       |                       |                       |  (event)              |
- * 	|                       +-----------------------+-----------------------+-----------------------+-----------------------|
- * 	|                       | EV_BTN_XX_DOWN        | [tick >  0]           | ST_BTN_XX_RISING      | tick--                |
- * 	|                       |						+-----------------------+-----------------------+-----------------------|
- * 	|                       |                       | [tick == 0]           | ST_BTN_XX_DOWN        |                       |
- * 	------------------------+-----------------------+-----------------------+-----------------------+------------------------
+/* Sensor debounce - bit-parallel vertical counters
+ *
+ * Bit i of every mask is the input task_sensor_cfg_list[i] (1 = pressed). Each
+ * tick the inputs are sampled at once (one IDR read per port) and debounced
+ * together: cnt[] holds one bit plane of every input counter, so counting,
+ * resetting and comparing against the window costs the same few bitwise
+ * operations for 1 or 32 inputs.
+ *
+ * 	------------------------+-----------------------+-----------------------------------------------
+ * 	| Sample vs state       | Counter               | Action
+ * 	|=======================+=======================+===============================================|
+ * 	| raw == state          | cnt = 0               | (bounce discarded)                            |
+ * 	|-----------------------+-----------------------+-----------------------------------------------|
+ * 	| raw != state          | cnt++                 | [cnt == limit] state = raw, cnt = 0,          |
+ * 	|                       |                       |  put_event_task_system(signal_down/signal_up) |
+ * 	------------------------+-----------------------+-----------------------------------------------
+ *
+ * limit = window + 2 samples, the same instant the former per-input
+ * statechart (UP, FALLING, DOWN, RISING) confirmed the edge. The window comes
+ * from the input's debounce profile (task_sensor_deb_t): fixed at tick_max, or
+ * adaptive, starting at tick_max and following twice the longest settle time
+ * seen (first to last change of a burst, rejected glitches included), never
+ * below tick_min. Each input has its own limit bits, so windows differ freely.
+ *
+ * EXTI mode (TASK_SENSOR_CFG_EXTI): an edge on the input's EXTI line arms it,
+ * and it is disarmed once raw == state again. Inputs without a line of their
+ * own (another port owns the line) are still sampled every tick and armed by
+ * raw != state. Nothing armed: no counting, and no sampling if every input
+ * has its line.
  */
-
-/* Events to excite Task Sensor */
-typedef enum task_sensor_ev {EV_BTN_UP,
-							 EV_BTN_DOWN} task_sensor_ev_t;
-
-/* States of Task Sensor */
-typedef enum task_sensor_st {ST_BTN_UP,
-							 ST_BTN_FALLING,
-							 ST_BTN_DOWN,
-						     ST_BTN_RISING} task_sensor_st_t;
-
 /* Identifier of Task Sensor */
 typedef enum task_sensor_id {
 	    ID_BTN_INGRESO,     // Botón S1
@@ -102,22 +91,57 @@ typedef enum task_sensor_id {
 	    ID_SW_DESACTIVAR    // Dip Switch 2
 } task_sensor_id_t;
 
+/* Debounce profile of an input (windows in ms, one sample per tick) */
+typedef enum task_sensor_deb_mode {
+	SENSOR_DEB_FIXED,					// tick_max always
+	SENSOR_DEB_ADAPTIVE					// From tick_max down to the observed settle time
+} task_sensor_deb_mode_t;
+
+typedef struct
+{
+	task_sensor_deb_mode_t	mode;
+	uint32_t				tick_max;	// Initial (and fixed) window
+	uint32_t				tick_min;	// Adaptive: safe floor
+} task_sensor_deb_t;
+
 typedef struct
 {
 	task_sensor_id_t	identifier;
 	GPIO_TypeDef *		gpio_port;
 	uint16_t			pin;
 	GPIO_PinState		pressed;
-	uint32_t			tick_max;
+	const task_sensor_deb_t *p_deb;
 	task_system_ev_t	signal_up;
 	task_system_ev_t	signal_down;
 } task_sensor_cfg_t;
 
+/* Bounce statistics of one input; a burst runs from the first change to the
+ * last one before the level settles (event) or comes back (glitch) */
+typedef struct
+{
+	uint32_t			bursts;							// Confirmed edges (events)
+	uint32_t			glitches;						// Rejected bursts
+	uint32_t			bounces;						// Extra changes inside confirmed bursts
+	uint32_t			bounce_max;						// Most extra changes in one burst
+	uint32_t			settle_max_us;					// Longest burst
+	uint32_t			settle_peak_us;					// Decaying peak the adaptive window follows
+	uint32_t			window;							// Current debounce window (ms)
+} task_sensor_bounce_t;
+
+typedef struct
+{
+	uint32_t			edges[TASK_SENSOR_QTY_MAX];		// EXTI edges per input, bounces included
+	uint32_t			ticks_busy;						// Ticks debounced
+	uint32_t			ticks_idle;						// Ticks without debounce: nothing armed
+} task_sensor_stats_t;
+
 typedef struct
 {
-	uint32_t			tick;
-	task_sensor_st_t	state;
-	task_sensor_ev_t	event;
+	uint32_t			raw;							// Last sample
+	uint32_t			state;							// Debounced level
+	uint32_t			cnt[TASK_SENSOR_CNT_BITS];		// Vertical counter, bit plane k
+	uint32_t			armed;							// Inputs being debounced
+	task_sensor_stats_t	stats;
 } task_sensor_dta_t;
 
 /********************** external data declaration ****************************/
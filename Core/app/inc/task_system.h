@@ -51,7 +51,7 @@ extern "C" {
 
 /********************** external data declaration ****************************/
 extern uint32_t g_task_system_cnt;
-extern volatile uint32_t g_task_system_tick_cnt;
+extern uint32_t g_task_system_last_tick;
 
 /********************** external functions declaration ***********************/
 extern void task_system_init(void *parameters);
@@ -77,7 +77,9 @@ typedef enum task_system_ev {
 	    EV_PARADA_EMERGENCIA,   // Se activó el switch de corte
 	    EV_PARADA_RESTAURADA,    // Se desactivó el switch de corte
 
-		EV_SYS_ACTIVE
+		EV_SYS_ACTIVE,
+
+		EV_SYS_QTY
 
 		/*EV_TIMEOUT  -> DETIENE LA ESCLARA (ST_SYS_IDLE) VEL = 0*/
 } task_system_ev_t;
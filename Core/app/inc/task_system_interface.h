@@ -48,14 +48,22 @@ extern "C" {
 /********************** macros ***********************************************/
 
 /********************** typedef **********************************************/
+/* Sensor event: the input that raised it and the capture time of its edge */
+typedef struct
+{
+	task_system_ev_t	event;
+	task_sensor_id_t	identifier;
+	app_stamp_t			stamp;
+} task_system_msg_t;
 
 /********************** external data declaration ****************************/
 
 /********************** external functions declaration ***********************/
 extern void init_queue_event_task_system(void);
-extern void put_event_task_system(task_system_ev_t event);
-extern task_system_ev_t get_event_task_system(void);
+extern void put_event_task_system(task_system_ev_t event, task_sensor_id_t identifier, const app_stamp_t *p_stamp);
+extern void get_event_task_system(task_system_msg_t *p_msg);
 extern bool any_event_task_system(void);
+extern void log_queue_event_task_system(void);
 
 /********************** End of CPP guard *************************************/
 #ifdef __cplusplus
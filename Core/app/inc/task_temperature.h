@@ -23,7 +23,7 @@ extern "C" {
 /********************** external data declaration ****************************/
 /* Contadores globales para el planificador */
 extern uint32_t g_task_temp_cnt;
-extern volatile uint32_t g_task_temp_tick_cnt;
+extern uint32_t g_task_temp_last_tick;
 
 /********************** external functions declaration ***********************/
 
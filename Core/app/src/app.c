@@ -42,22 +42,78 @@
 /* Demo includes. */
 #include "logger.h"
 #include "dwt.h"
+#include "profiler.h"
 
 /* Application & Tasks includes. */
 #include "board.h"
+#include "app.h"
 #include "task_system.h"
+#include "task_system_attribute.h"
+#include "task_sensor_attribute.h"
+#include "task_system_interface.h"
 #include "task_actuator.h"
+#include "task_actuator_attribute.h"
+#include "task_actuator_interface.h"
 #include "task_sensor.h"
 #include "task_display.h"
+#include "display.h"
 #include "task_temperature.h"
 
 /********************** macros and definitions *******************************/
 #define G_APP_CNT_INI		0ul
-#define G_APP_TICK_CNT_INI	0ul
 
 #define TASK_X_WCET_INI		0ul
 #define TASK_X_DELAY_MIN	0ul
 
+/* Time-Triggered scheduler: 1 = each task is released only when due
+ * (period/offset), 0 = every task is released on every tick (legacy loop,
+ * useful to compare the load report against the time-triggered one) */
+#define APP_CFG_TIME_TRIGGERED	(1)
+
+/* Release period & offset of each task (ticks of 1 mS) */
+#define TASK_SEN_PERIOD		1ul
+#define TASK_SEN_OFFSET		0ul
+#define TASK_ACT_PERIOD		1ul
+#define TASK_ACT_OFFSET		0ul
+#define TASK_DSP_PERIOD		1ul		// Every tick: pumps the asynchronous LCD engine
+#define TASK_DSP_OFFSET		0ul
+#define TASK_TEMP_PERIOD	10ul
+#define TASK_TEMP_OFFSET	7ul
+#define TASK_SYS_PERIOD		1ul
+#define TASK_SYS_OFFSET		0ul
+
+/* Execution level of each task: the sensor -> system -> actuator chain is
+ * short and time critical, display & temperature are slow (blocking) */
+#define TASK_SEN_LEVEL		APP_LEVEL_FG
+#define TASK_ACT_LEVEL		APP_LEVEL_FG
+#define TASK_DSP_LEVEL		APP_LEVEL_BG
+#define TASK_TEMP_LEVEL		APP_LEVEL_BG
+#define TASK_SYS_LEVEL		APP_LEVEL_FG
+
+/* Idle: 1 = sleep with WFI while no tick is pending (idle time is measured
+ * with DWT CYCCNT), 0 = busy loop */
+#define APP_CFG_IDLE_SLEEP	(1)
+
+/* Execution levels: 1 = foreground/background, the APP_LEVEL_FG tasks run in
+ * PendSV (pended by every SysTick) and preempt the background loop, so a
+ * blocking background task can not delay them, 0 = every task runs in the
+ * cooperative background loop */
+#ifndef APP_CFG_FG_BG
+#define APP_CFG_FG_BG		(1)
+#endif
+
+/* PendSV (foreground level): lowest priority, below SysTick and the EXTI lines */
+#define APP_FG_IRQ_PRIORITY	(15ul)
+
+/* Performance report period (ticks of 1 mS) */
+#define APP_LOG_PERIOD		10000ul
+
+typedef enum {
+	APP_LEVEL_FG,					// PendSV, preempts the background
+	APP_LEVEL_BG,					// app_update() loop
+	APP_LEVEL_QTY
+} app_level_t;
+
 typedef struct {
 	void (*task_init)(void *);		// Pointer to task (must be a
 									// 'void (void *)' function)
@@ -65,38 +121,334 @@ typedef struct {
 									// 'void (void *)' function)
 	void *parameters;				// Pointer to parameters
 	const char *task_name;
+	uint32_t period;				// Release period (ticks)
+	uint32_t offset;				// Release offset (ticks)
+	app_level_t level;				// Execution level (APP_CFG_FG_BG)
 } task_cfg_t;
 
 typedef struct {
     uint32_t WCET;				// Worst-case execution time (microseconds)
+    profiler_dta_t profile;		// Execution time (cycles): min/mean/max & histogram
+    uint32_t next_release;		// Tick of the next release
+    uint32_t release_cnt;		// Releases in the current report window
+    profiler_dta_t release;		// Release latency (cycles): release tick -> actual start
+    uint32_t skipped_cnt;		// Periods skipped because the scheduler was late
 } task_dta_t;
 
+typedef struct {
+	uint32_t last_tick;			// Last tick processed by the scheduler
+	uint32_t backlog_cnt;		// Scheduler passes that found more than one pending tick
+	uint32_t backlog_ticks;		// Ticks processed late (pending beyond the first one)
+	uint32_t backlog_max;		// Worst number of pending ticks in one pass
+	uint32_t time_us;			// Time spent in tasks in the last pass
+} app_sched_dta_t;
+
+typedef struct {
+	uint32_t busy_us;			// Time spent in tasks in the current report window
+	uint32_t busy_max_us;		// Worst tick load in the current report window
+	uint32_t window_tick;		// Tick (g_app_tick_cnt) at the start of the report window
+	uint64_t idle_cycles;		// Cycles spent sleeping in the current report window
+} app_load_dta_t;
+
+typedef struct {
+	uint32_t base_us;			// HAL tick (since reset) when CYCCNT started, in uS
+	uint32_t mark_us[APP_BOOT_QTY];	// Time from reset to each milestone, 0 = not reached yet
+} app_boot_dta_t;
+
 
 /********************** internal data declaration ****************************/
 const task_cfg_t task_cfg_list[]	= {
-		{task_sensor_init, 		task_sensor_update, 	NULL, "TASK_SENSOR"},
-		{task_actuator_init,	task_actuator_update, 	NULL, "TASK_ACTUATOR"},
-		{task_display_init,     task_display_update,    NULL, "TASK_DISPLAY"},
-		{task_temperature_init, task_temperature_update, NULL, "TASK_TEMP"},
-		{task_system_init, 		task_system_update, 	NULL, "TASK_SYS"},
+		{task_sensor_init, 		task_sensor_update, 	NULL, "TASK_SENSOR",	TASK_SEN_PERIOD,	TASK_SEN_OFFSET,	TASK_SEN_LEVEL},
+		{task_actuator_init,	task_actuator_update, 	NULL, "TASK_ACTUATOR",	TASK_ACT_PERIOD,	TASK_ACT_OFFSET,	TASK_ACT_LEVEL},
+		{task_display_init,     task_display_update,    NULL, "TASK_DISPLAY",	TASK_DSP_PERIOD,	TASK_DSP_OFFSET,	TASK_DSP_LEVEL},
+		{task_temperature_init, task_temperature_update, NULL, "TASK_TEMP",		TASK_TEMP_PERIOD,	TASK_TEMP_OFFSET,	TASK_TEMP_LEVEL},
+		{task_system_init, 		task_system_update, 	NULL, "TASK_SYS",		TASK_SYS_PERIOD,	TASK_SYS_OFFSET,	TASK_SYS_LEVEL},
 };
 
 #define TASK_QTY	(sizeof(task_cfg_list)/sizeof(task_cfg_t))
 
+#if 1 == APP_CFG_FG_BG
+#define APP_TASK_LEVEL(index)	(task_cfg_list[index].level)
+#else
+#define APP_TASK_LEVEL(index)	(APP_LEVEL_BG)
+#endif
+
 /********************** internal functions declaration ***********************/
 
 /********************** internal data definition *****************************/
 const char *p_sys	= " Bare Metal - Event-Triggered Systems (ETS)\r\n";
 const char *p_app	= " App - Model Integration\r\n";
+const char *p_app_level[APP_LEVEL_QTY] = {"FG", "BG"};
+const char *p_app_boot[APP_BOOT_QTY] = {"SENSORES", "DISPLAY"};
+
+static volatile bool app_fg_enable;	// Foreground level running (after app_init)
 
 /********************** external data declaration ****************************/
 uint32_t g_app_cnt;
 uint32_t g_app_time_us;
 
 volatile uint32_t g_app_tick_cnt;
+volatile uint32_t g_app_tick_cycle;	// CYCCNT at the last tick
+volatile uint32_t g_app_exti0_cyc;	// CYCCNT on entry to EXTI0_IRQHandler()
+volatile bool g_app_report_req;	// Pedido de reporte de perfiles (botón B1)
 uint32_t g_log_timer_ticks = 0; // Temporizador para el reporte de rendimiento
 
 task_dta_t task_dta_list[TASK_QTY];
+app_load_dta_t app_load_dta;
+app_sched_dta_t app_sched_dta[APP_LEVEL_QTY];
+app_boot_dta_t app_boot_dta;
+
+static void app_log_load(void)
+{
+	uint32_t index;
+	uint32_t tick_cnt;
+	uint32_t release_cnt = 0;
+	uint32_t release_max;
+	uint32_t busy_avg_us = 0;
+	uint32_t saved_pct = 0;
+	uint64_t window_cycles;
+	uint32_t usage_pct_x100 = 0;
+
+	tick_cnt = g_app_tick_cnt - app_load_dta.window_tick;
+
+	for (index = 0; TASK_QTY > index; index++)
+	{
+		release_cnt += task_dta_list[index].release_cnt;
+	}
+
+	/* Releases the legacy loop would have done: every task on every tick */
+	release_max = tick_cnt * TASK_QTY;
+
+	if (0 < tick_cnt)
+	{
+		busy_avg_us = app_load_dta.busy_us / tick_cnt;
+		saved_pct = ((release_max - release_cnt) * 100ul) / release_max;
+	}
+
+	/* Real CPU usage: whatever is not spent sleeping in the window */
+	window_cycles = (uint64_t)tick_cnt * (SystemCoreClock / 1000ul);
+	if ((0 < window_cycles) && (app_load_dta.idle_cycles < window_cycles))
+	{
+		usage_pct_x100 = (uint32_t)(((window_cycles - app_load_dta.idle_cycles) * 10000ull) / window_cycles);
+	}
+
+	LOGGER_LOG("   CARGA POR TICK (%lu ticks)\r\n", tick_cnt);
+	LOGGER_LOG("----------------------------------------\r\n");
+
+	for (index = 0; TASK_QTY > index; index++)
+	{
+		LOGGER_LOG(" [%s]: \t%lu rel (T=%lu, O=%lu, %s)\r\n", task_cfg_list[index].task_name,
+				   task_dta_list[index].release_cnt, task_cfg_list[index].period, task_cfg_list[index].offset,
+				   p_app_level[APP_TASK_LEVEL(index)]);
+	}
+
+	LOGGER_LOG("----------------------------------------\r\n");
+	LOGGER_LOG(" LIBERACIONES:   \t%lu / %lu\r\n", release_cnt, release_max);
+	LOGGER_LOG(" AHORRO vs TICK: \t%lu %%\r\n", saved_pct);
+	LOGGER_LOG(" CARGA MEDIA:    \t%lu us/tick\r\n", busy_avg_us);
+	LOGGER_LOG(" CARGA MAXIMA:   \t%lu us/tick\r\n", app_load_dta.busy_max_us);
+#if 1 == APP_CFG_IDLE_SLEEP
+	LOGGER_LOG(" USO CPU REAL:   \t%lu.%02lu %%\r\n", usage_pct_x100 / 100ul, usage_pct_x100 % 100ul);
+	LOGGER_LOG(" MARGEN REAL:    \t%lu.%02lu %%\r\n", (10000ul - usage_pct_x100) / 100ul, (10000ul - usage_pct_x100) % 100ul);
+#endif
+	LOGGER_LOG("========================================\r\n\r\n");
+
+	/* The foreground level updates these too */
+	__asm("CPSID i");	/* disable interrupts*/
+	for (index = 0; TASK_QTY > index; index++)
+	{
+		task_dta_list[index].release_cnt = 0;
+	}
+	app_load_dta.busy_us = 0;
+	app_load_dta.busy_max_us = 0;
+	app_load_dta.window_tick = g_app_tick_cnt;
+	app_load_dta.idle_cycles = 0;
+	__asm("CPSIE i");	/* enable interrupts*/
+}
+
+static void app_idle(void)
+{
+#if 1 == APP_CFG_IDLE_SLEEP
+	uint32_t idle_start;
+
+	/* With interrupts masked, WFI still wakes up on a pending interrupt, so a
+	 * tick arriving between the check and the WFI can not be missed */
+	__asm("CPSID i");	/* disable interrupts*/
+	if (app_sched_dta[APP_LEVEL_BG].last_tick == g_app_tick_cnt)
+	{
+		idle_start = cycle_counter_get();
+		__WFI();
+		app_load_dta.idle_cycles += (uint32_t)(cycle_counter_get() - idle_start);
+	}
+	__asm("CPSIE i");	/* enable interrupts*/
+#endif
+}
+
+/* Run the due tasks of one execution level, returns the ticks processed */
+static uint32_t app_level_update(app_level_t level)
+{
+	uint32_t index;
+	uint32_t cycle_counter_start;
+	uint32_t cycle_counter_time_us;
+	uint32_t tick_now;
+	uint32_t tick_cycle;
+	uint32_t backlog;
+	uint32_t period;
+	uint32_t late;
+	uint32_t skipped;
+	uint32_t time_us = 0;
+	app_sched_dta_t *p_sched = &app_sched_dta[level];
+
+	/* Read the tick and its CYCCNT stamp consistently (retry if a tick
+	 * arrives in between) */
+	do
+	{
+		tick_now = g_app_tick_cnt;
+		tick_cycle = g_app_tick_cycle;
+	} while (tick_now != g_app_tick_cnt);
+
+	/* Check if it's time to run tasks */
+	if (p_sched->last_tick == tick_now)
+	{
+		return 0;
+	}
+
+	/* Pending ticks: more than one means the previous pass overran */
+	backlog = tick_now - p_sched->last_tick;
+	p_sched->last_tick = tick_now;
+
+	if (1ul < backlog)
+	{
+		p_sched->backlog_cnt++;
+		p_sched->backlog_ticks += backlog - 1ul;
+		if (p_sched->backlog_max < backlog)
+		{
+			p_sched->backlog_max = backlog;
+		}
+	}
+
+	/* Go through the task arrays */
+	for (index = 0; TASK_QTY > index; index++)
+	{
+		if (level != APP_TASK_LEVEL(index))
+		{
+			continue;
+		}
+
+#if 1 == APP_CFG_TIME_TRIGGERED
+		period = task_cfg_list[index].period;
+#else
+		period = 1ul;
+#endif
+		/* Skip the task until its release tick is reached */
+		if (0 > (int32_t)(tick_now - task_dta_list[index].next_release))
+		{
+			continue;
+		}
+
+		/* Release once: tasks catch up on their own ticks, so the periods
+		 * already missed are skipped (and counted) instead of replayed */
+		late = tick_now - task_dta_list[index].next_release;
+		skipped = late / period;
+		task_dta_list[index].skipped_cnt += skipped;
+		task_dta_list[index].next_release += (skipped + 1ul) * period;
+
+		task_dta_list[index].release_cnt++;
+
+		cycle_counter_start = profiler_start();
+
+		/* Release latency: from the tick the task was due to its start */
+		profiler_add(&task_dta_list[index].release,
+					 (cycle_counter_start - tick_cycle) + (late * (SystemCoreClock / 1000ul)));
+
+		/* Run task_x_update (background tasks also account the foreground
+		 * time that preempted them) */
+		(*task_cfg_list[index].task_update)(task_cfg_list[index].parameters);
+
+		cycle_counter_time_us = profiler_stop(&task_dta_list[index].profile, cycle_counter_start) / cycles_per_us;
+
+		/* Update variables */
+		time_us += cycle_counter_time_us;
+
+		if (task_dta_list[index].WCET < cycle_counter_time_us)
+		{
+			task_dta_list[index].WCET = cycle_counter_time_us;
+		}
+	}
+
+	p_sched->time_us = time_us;
+
+	/* Update tick load (shared by both levels) */
+	__asm("CPSID i");	/* disable interrupts*/
+	app_load_dta.busy_us += time_us;
+	if (app_load_dta.busy_max_us < time_us)
+	{
+		app_load_dta.busy_max_us = time_us;
+	}
+	__asm("CPSIE i");	/* enable interrupts*/
+
+	return backlog;
+}
+
+static void app_log_release(void)
+{
+	uint32_t index;
+	uint32_t level;
+	const profiler_dta_t *p_release;
+	const app_sched_dta_t *p_sched;
+	bool backlog = false;
+
+	LOGGER_LOG("   LIBERACION -> INICIO (us)\r\n");
+	LOGGER_LOG("----------------------------------------\r\n");
+
+	for (index = 0; TASK_QTY > index; index++)
+	{
+		p_release = &task_dta_list[index].release;
+
+		/* Jitter: spread between the earliest and the latest start */
+		LOGGER_LOG(" [%s]: max %lu jit %lu salt %lu\r\n", task_cfg_list[index].task_name,
+				   p_release->max / cycles_per_us,
+				   (0 < p_release->cnt) ? ((p_release->max - p_release->min) / cycles_per_us) : 0ul,
+				   task_dta_list[index].skipped_cnt);
+	}
+
+	LOGGER_LOG("----------------------------------------\r\n");
+
+	for (level = 0; APP_LEVEL_QTY > level; level++)
+	{
+		p_sched = &app_sched_dta[level];
+		LOGGER_LOG(" BACKLOG %s: \t%lu ev, %lu ticks (max %lu)\r\n", p_app_level[level],
+				   p_sched->backlog_cnt, p_sched->backlog_ticks, p_sched->backlog_max);
+		backlog |= (0 < p_sched->backlog_cnt);
+	}
+
+	if (true == backlog) {
+		LOGGER_LOG(" [!] ALERTA: TICKS PROCESADOS CON ATRASO\r\n");
+	}
+	LOGGER_LOG("========================================\r\n");
+}
+
+static void app_log_boot(void)
+{
+	uint32_t mark;
+
+	LOGGER_LOG("   ARRANQUE (reset -> hito)\r\n");
+	LOGGER_LOG("----------------------------------------\r\n");
+
+	for (mark = 0; APP_BOOT_QTY > mark; mark++)
+	{
+		if (0 < app_boot_dta.mark_us[mark])
+		{
+			LOGGER_LOG(" [%s]: \t%lu.%03lu ms\r\n", p_app_boot[mark],
+					   app_boot_dta.mark_us[mark] / 1000ul, app_boot_dta.mark_us[mark] % 1000ul);
+		}
+		else
+		{
+			LOGGER_LOG(" [%s]: \tpendiente\r\n", p_app_boot[mark]);
+		}
+	}
+	LOGGER_LOG("========================================\r\n");
+}
 
 static void app_log_performance(void)
 {
@@ -122,21 +474,69 @@ static void app_log_performance(void)
     LOGGER_LOG("----------------------------------------\r\n");
     LOGGER_LOG(" SUMA TOTAL WCET: \t%lu us\r\n", total_wcet_us);
     LOGGER_LOG(" TIEMPO DISPONIBLE:\t1000 us (1 ms)\r\n");
-    LOGGER_LOG(" FACTOR USO CPU:  \t%.2f %%\r\n", cpu_usage_percent);
+    LOGGER_LOG(" FACTOR USO CPU:  \t%.2f %% (peor caso)\r\n", cpu_usage_percent);
 
     if (cpu_usage_percent >= 100.0f) {
         LOGGER_LOG(" [!] ALERTA: SOBRECARGA DEL SISTEMA DETECTADA\r\n");
     } else {
         LOGGER_LOG(" [OK] SISTEMA ESTABLE Y CON MARGEN\r\n");
     }
-    LOGGER_LOG("========================================\r\n\r\n");
+    LOGGER_LOG("========================================\r\n");
+
+    app_log_release();
+    app_log_boot();
+
+    /* Event queues: high watermark and overflows since boot */
+    LOGGER_LOG("   COLAS DE EVENTOS\r\n");
+    LOGGER_LOG("----------------------------------------\r\n");
+    log_queue_event_task_system();
+    displayLogStats();
+    task_display_log_stats();
+    task_sensor_log_stats();
+    task_actuator_log_latency();
+    LOGGER_LOG("========================================\r\n");
+
+    app_log_load();
 }
 
 /********************** external functions definition ************************/
+void app_log_profile(void)
+{
+	uint32_t index;
+
+	LOGGER_LOG("\r\n========================================\r\n");
+	LOGGER_LOG("   PERFIL DE EJECUCION (ciclos)\r\n");
+	LOGGER_LOG("   overhead descontado: %lu ciclos\r\n", g_profiler_overhead);
+	LOGGER_LOG("========================================\r\n");
+
+	for (index = 0; TASK_QTY > index; index++)
+	{
+		profiler_log(task_cfg_list[index].task_name, &task_dta_list[index].profile);
+	}
+
+	profiler_log("Parada rapida (EXTI -> motores)", &g_task_actuator_safety_profile);
+
+	LOGGER_LOG("========================================\r\n\r\n");
+}
+
 void app_init(void)
 {
 	uint32_t index;
 
+	/* CYCCNT is free-running from here on: nobody resets it, measurements
+	 * are differences against a start value. Started before the task inits,
+	 * their timed states (LCD power-up) are deadlines on CYCCNT */
+	cycle_counter_init();
+	profiler_init();
+
+	/* HAL tick counts from HAL_Init() (just after reset): boot milestones are
+	 * that offset plus CYCCNT, good to 1 mS + 1 uS */
+	app_boot_dta.base_us = HAL_GetTick() * 1000ul;
+	for (index = 0; APP_BOOT_QTY > index; index++)
+	{
+		app_boot_dta.mark_us[index] = 0;
+	}
+
 	/* Print out: Application Initialized */
 	LOGGER_LOG("\r\n");
 	LOGGER_LOG("%s is running - Tick [mS] = %lu\r\n", GET_NAME(app_init), HAL_GetTick());
@@ -157,53 +557,148 @@ void app_init(void)
 
 		/* Init variables */
 		task_dta_list[index].WCET = TASK_X_WCET_INI;
+		profiler_reset(&task_dta_list[index].profile);
+		profiler_reset(&task_dta_list[index].release);
+		task_dta_list[index].release_cnt = 0;
+		task_dta_list[index].skipped_cnt = 0;
 	}
 
-	cycle_counter_init();
+	/* Ticks elapsed while the tasks were initialized are not a backlog */
+	for (index = 0; APP_LEVEL_QTY > index; index++)
+	{
+		app_sched_dta[index].last_tick = g_app_tick_cnt;
+		app_sched_dta[index].backlog_cnt = 0;
+		app_sched_dta[index].backlog_ticks = 0;
+		app_sched_dta[index].backlog_max = 0;
+		app_sched_dta[index].time_us = 0;
+	}
+
+	for (index = 0; TASK_QTY > index; index++)
+	{
+#if 1 == APP_CFG_TIME_TRIGGERED
+		task_dta_list[index].next_release = app_sched_dta[APP_TASK_LEVEL(index)].last_tick + 1ul + task_cfg_list[index].offset;
+#else
+		task_dta_list[index].next_release = app_sched_dta[APP_TASK_LEVEL(index)].last_tick + 1ul;
+#endif
+	}
+
+	app_load_dta.busy_us = 0;
+	app_load_dta.busy_max_us = 0;
+	app_load_dta.window_tick = g_app_tick_cnt;
+	app_load_dta.idle_cycles = 0;
+	g_log_timer_ticks = APP_LOG_PERIOD;
+	g_app_report_req = false;
+
+#if 1 == APP_CFG_IDLE_SLEEP
+	/* Keep the debug/trace (SWO logger) clock running while sleeping */
+	DBGMCU->CR |= DBGMCU_CR_DBG_SLEEP;
+#endif
+
+#if 1 == APP_CFG_FG_BG
+	/* From here on every SysTick pends PendSV, which runs the foreground */
+	HAL_NVIC_SetPriority(PendSV_IRQn, APP_FG_IRQ_PRIORITY, 0);
+	app_fg_enable = true;
+#endif
 }
 
 void app_update(void)
 {
-	uint32_t index;
-	uint32_t cycle_counter_time_us;
+	uint32_t backlog;
 
-	/* Check if it's time to run tasks */
-	if (G_APP_TICK_CNT_INI < g_app_tick_cnt)
-    {
-    	g_app_tick_cnt--;
+	/* Background level (every task in the cooperative mode) */
+	backlog = app_level_update(APP_LEVEL_BG);
 
+	if (0 < backlog)
+    {
     	/* Update App Counter */
     	g_app_cnt++;
-    	g_app_time_us = 0;
+    	g_app_time_us = app_sched_dta[APP_LEVEL_BG].time_us;
 
-    	/* Go through the task arrays */
-    	for (index = 0; TASK_QTY > index; index++)
+    	/* Periodic performance report */
+    	if (backlog <= g_log_timer_ticks)
+    	{
+    		g_log_timer_ticks -= backlog;
+    	}
+    	else
     	{
-			cycle_counter_reset();
+    		app_log_performance();
+    		g_log_timer_ticks = APP_LOG_PERIOD;
+    	}
 
-    		/* Run task_x_update */
-			(*task_cfg_list[index].task_update)(task_cfg_list[index].parameters);
+    	/* On demand profile report */
+    	if (true == g_app_report_req)
+    	{
+    		g_app_report_req = false;
+    		app_log_profile();
+    	}
+    }
+	else
+	{
+		/* No task due: sleep until the next interrupt */
+		app_idle();
+	}
+}
 
-			cycle_counter_time_us = cycle_counter_time_us();
+void app_boot_mark(app_boot_mark_t mark)
+{
+	/* Only the first call counts: tasks call it from their update unconditionally */
+	if ((APP_BOOT_QTY > mark) && (0 == app_boot_dta.mark_us[mark]))
+	{
+		app_boot_dta.mark_us[mark] = app_boot_dta.base_us + (cycle_counter_get() / cycles_per_us);
+	}
+}
 
-			/* Update variables */
-	    	g_app_time_us += cycle_counter_time_us;
+void app_stamp(app_stamp_t *p_stamp)
+{
+	/* A SysTick in between leaves tick one behind cyc: tick is only a label */
+	p_stamp->tick = g_app_tick_cnt;
+	p_stamp->cyc = cycle_counter_get();
+}
 
-			if (task_dta_list[index].WCET < cycle_counter_time_us)
-			{
-				task_dta_list[index].WCET = cycle_counter_time_us;
-			}
-	    }
-    }
+void app_fg_update(void)
+{
+#if 1 == APP_CFG_FG_BG
+	/* Foreground level, called from PendSV_Handler() */
+	if (true == app_fg_enable)
+	{
+		(void)app_level_update(APP_LEVEL_FG);
+	}
+#endif
 }
 
 void HAL_SYSTICK_Callback(void)
 {
+	/* Single free-running timebase: tasks read it and keep their own last tick */
+	g_app_tick_cycle = cycle_counter_get();
 	g_app_tick_cnt++;
-	g_task_sensor_tick_cnt++;
-	g_task_system_tick_cnt++;
-	g_task_actuator_tick_cnt++;
-	g_task_temp_tick_cnt++;
+
+#if 1 == APP_CFG_FG_BG
+	/* Foreground level: PendSV runs as soon as no other ISR is active */
+	if (true == app_fg_enable)
+	{
+		SCB->ICSR = SCB_ICSR_PENDSVSET_Msk;
+	}
+#endif
+}
+
+void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin)
+{
+	/* Emergency stop switch: motors off right here, the statechart still gets
+	 * EV_PARADA_EMERGENCIA through the debounced sensor path (UI and alarm).
+	 * The line also fires on the rising edge (sensor EXTI mode): level check */
+	if ((SW_DESACTIVAR_Pin == GPIO_Pin) && (0 == (SW_DESACTIVAR_PORT->IDR & SW_DESACTIVAR_PIN)))
+	{
+		safety_stop_task_actuator(g_app_exti0_cyc);
+	}
+
+	/* Sensor lines: arm the debounce of that input */
+	task_sensor_exti(GPIO_Pin);
+
+	/* User button (B1): request the profile report */
+	if (B1_Pin == GPIO_Pin)
+	{
+		g_app_report_req = true;
+	}
 }
 
 /********************** end of file ******************************************/
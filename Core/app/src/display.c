@@ -2,14 +2,19 @@
 #include "board.h"
 #include "display.h"
 #include "dwt.h"        // Necesario para los retardos de microsegundos
+#include "ring_buffer.h"
+#include "logger.h"
+#include "profiler.h"
 #include <stdint.h>
 #include <stdbool.h>
+#include <string.h>
 
 // --- DEFINICIONES DE COMANDOS LCD (HD44780) ---
 #define DISPLAY_IR_CLEAR_DISPLAY   0b00000001
 #define DISPLAY_IR_ENTRY_MODE_SET  0b00000100
 #define DISPLAY_IR_DISPLAY_CONTROL 0b00001000
 #define DISPLAY_IR_FUNCTION_SET    0b00100000
+#define DISPLAY_IR_SET_CGRAM_ADDR  0b01000000
 #define DISPLAY_IR_SET_DDRAM_ADDR  0b10000000
 
 #define DISPLAY_IR_ENTRY_MODE_SET_INCREMENT 0b00000010
@@ -34,174 +39,1366 @@
 // Direcciones de memoria para 16x2
 #define DISPLAY_LINE1_ADDR 0x00
 #define DISPLAY_LINE2_ADDR 0x40
+#define DISPLAY_COLS       16
+#define DISPLAY_ROWS       2
+#define DISPLAY_ADDR_NONE  0xFF     // AC fuera de DDRAM (tras escribir CGRAM)
+#define DISPLAY_GLYPH_ROWS 8        // Filas de un glifo 5x8
 
 // Tipos de Mensaje
 #define DISPLAY_RS_INSTRUCTION 0
 #define DISPLAY_RS_DATA        1
 
 // --- TIEMPOS OPTIMIZADOS (Microsegundos) ---
-#define US_PULSE_WIDTH      2   // Ancho del pulso EN (>450ns)
+#define US_PULSE_WIDTH      2   // Ancho del pulso EN en la lectura de BF (>450ns, tDDR < 360ns)
 #define US_INTER_NIBBLE     2   // Tiempo entre nibbles
 #define US_EXEC_STD         50  // Tiempo ejecución comando estándar (>37us)
 #define MS_EXEC_CLEAR       2   // Tiempo ejecución Clear/Home (>1.52ms)
+#define MS_POWER_ON         50  // Vcc estable -> primer comando (>40ms)
+
+// --- MOTOR ASÍNCRONO ---
+#define DISPLAY_QUEUE_SIZE  64      // Códigos pendientes (potencia de 2, > 1 pantalla completa)
+#define DISPLAY_CODE_RS     0x0100  // Bit 8 del código encolado: RS = dato
+#define DISPLAY_CODE_NIBBLE 0x0200  // Bit 9: arranque en 8 bits, solo el nibble alto;
+                                    // el bajo lleva la espera posterior en ms
+#define US_SPIN_MAX         US_INTER_NIBBLE // Pausas que se esperan dentro de displayUpdate()
+
+// Busy flag (requiere el pin RW cableado, ver LCD_RW_* en board.h):
+// 1 = tras cada comando se lee BF y se sigue apenas el HD44780 está libre, con
+//     los tiempos fijos como timeout; 0 = RW a GND, solo tiempos fijos
+#ifndef DISPLAY_CFG_BUSY_FLAG
+#define DISPLAY_CFG_BUSY_FLAG  (0)
+#endif
+#define US_BF_SLICE         200 // Sondeo máximo de BF por llamada a displayUpdate()
+
+// Escritura del bus:
+// 1 = cada nibble es un store a BSRR por puerto con máscaras precalculadas;
+// 0 = un HAL_GPIO_WritePin() por pin (camino original, queda para comparar
+//     los ciclos/caracter de displayLogStats())
+#ifndef DISPLAY_CFG_BUS_LUT
+#define DISPLAY_CFG_BUS_LUT    (1)
+#endif
+
+// Tiempos del pulso de EN en ciclos (a 64 MHz: 62 ns y 500 ns)
+#define CYC_EN_SETUP        (SystemCoreClock / 16000000)    // RS/datos -> EN alto (tAS > 40 ns)
+#define CYC_EN_PULSE        (SystemCoreClock / 2000000)     // EN alto (PWEH > 450 ns)
+
+#if (1 == DISPLAY_CFG_BUS_LUT)
+// Máscaras BSRR de RS + D4..D7 para los 16 nibbles, armadas en compilación a
+// partir de board.h. Los pines pueden repartirse en hasta dos puertos: el de
+// D4 (puerto 0) y el de D7 (puerto 1). Cada pin aporta su bit de set (0..15)
+// o de reset (16..31) solo en la tabla de su puerto.
+#define LCD_BSRR_PIN(port, pinPort, pin, on) \
+    (((port) != (pinPort)) ? 0u : ((on) ? (uint32_t)(pin) : ((uint32_t)(pin) << 16)))
+
+#define LCD_BSRR_NIBBLE(port, rs, n) ( \
+    LCD_BSRR_PIN(port, LCD_RS_PORT, LCD_RS_PIN, (rs)) | \
+    LCD_BSRR_PIN(port, LCD_D4_PORT, LCD_D4_PIN, (n) & 0x01) | \
+    LCD_BSRR_PIN(port, LCD_D5_PORT, LCD_D5_PIN, (n) & 0x02) | \
+    LCD_BSRR_PIN(port, LCD_D6_PORT, LCD_D6_PIN, (n) & 0x04) | \
+    LCD_BSRR_PIN(port, LCD_D7_PORT, LCD_D7_PIN, (n) & 0x08))
+
+#define LCD_BSRR_ROW(port, rs) { \
+    LCD_BSRR_NIBBLE(port, rs, 0x0), LCD_BSRR_NIBBLE(port, rs, 0x1), \
+    LCD_BSRR_NIBBLE(port, rs, 0x2), LCD_BSRR_NIBBLE(port, rs, 0x3), \
+    LCD_BSRR_NIBBLE(port, rs, 0x4), LCD_BSRR_NIBBLE(port, rs, 0x5), \
+    LCD_BSRR_NIBBLE(port, rs, 0x6), LCD_BSRR_NIBBLE(port, rs, 0x7), \
+    LCD_BSRR_NIBBLE(port, rs, 0x8), LCD_BSRR_NIBBLE(port, rs, 0x9), \
+    LCD_BSRR_NIBBLE(port, rs, 0xA), LCD_BSRR_NIBBLE(port, rs, 0xB), \
+    LCD_BSRR_NIBBLE(port, rs, 0xC), LCD_BSRR_NIBBLE(port, rs, 0xD), \
+    LCD_BSRR_NIBBLE(port, rs, 0xE), LCD_BSRR_NIBBLE(port, rs, 0xF) }
+
+// Bus de 8 bits: D0..D3 tienen su propia tabla, sin RS. Sus bits no se pisan con
+// los de RS + D4..D7, así que el store de un byte es la OR de las dos tablas
+#define LCD_BSRR_LOW(port, n) ( \
+    LCD_BSRR_PIN(port, LCD_D0_PORT, LCD_D0_PIN, (n) & 0x01) | \
+    LCD_BSRR_PIN(port, LCD_D1_PORT, LCD_D1_PIN, (n) & 0x02) | \
+    LCD_BSRR_PIN(port, LCD_D2_PORT, LCD_D2_PIN, (n) & 0x04) | \
+    LCD_BSRR_PIN(port, LCD_D3_PORT, LCD_D3_PIN, (n) & 0x08))
+
+#define LCD_BSRR_LOW_ROW(port) { \
+    LCD_BSRR_LOW(port, 0x0), LCD_BSRR_LOW(port, 0x1), LCD_BSRR_LOW(port, 0x2), LCD_BSRR_LOW(port, 0x3), \
+    LCD_BSRR_LOW(port, 0x4), LCD_BSRR_LOW(port, 0x5), LCD_BSRR_LOW(port, 0x6), LCD_BSRR_LOW(port, 0x7), \
+    LCD_BSRR_LOW(port, 0x8), LCD_BSRR_LOW(port, 0x9), LCD_BSRR_LOW(port, 0xA), LCD_BSRR_LOW(port, 0xB), \
+    LCD_BSRR_LOW(port, 0xC), LCD_BSRR_LOW(port, 0xD), LCD_BSRR_LOW(port, 0xE), LCD_BSRR_LOW(port, 0xF) }
+
+#define LCD_BUS_PORT0       LCD_D4_PORT
+#define LCD_BUS_PORT1       LCD_D7_PORT
+#define LCD_BUS_SPLIT       (LCD_BUS_PORT0 != LCD_BUS_PORT1)
+#endif
+
+// Backend DISPLAY_CONNECTION_GPIO_4BITS_DMA: TIM2 marca ranuras fijas y en cada
+// una el DMA1 escribe una palabra precalculada en el BSRR de cada puerto del bus
+// (TIM2_UP -> canal 2 -> puerto 0, TIM2_CH1 -> canal 5 -> puerto 1, a mitad de
+// ranura). La CPU solo arma la ráfaga; 0 = sin TIM2/DMA1, el backend cae a GPIO.
+#ifndef DISPLAY_CFG_DMA
+#define DISPLAY_CFG_DMA        (DISPLAY_CFG_BUS_LUT)
+#endif
+
+#if (1 == DISPLAY_CFG_DMA)
+#if (1 != DISPLAY_CFG_BUS_LUT)
+#error "DISPLAY_CFG_DMA requiere DISPLAY_CFG_BUS_LUT"
+#endif
+#define DISPLAY_DMA_TIM         TIM2
+#define DISPLAY_DMA_CH_PORT0    DMA1_Channel2   // TIM2_UP
+#define DISPLAY_DMA_CH_PORT1    DMA1_Channel5   // TIM2_CH1
+#define DISPLAY_DMA_IFCR        (DMA_IFCR_CGIF2 | DMA_IFCR_CGIF5)
+
+// Ranura de 14 us: datos | EN alto | EN bajo por nibble, más una ranura libre
+// por byte, así del EN bajo del nibble bajo al EN alto del próximo byte pasan
+// 3 ranuras (42 us > 37 us de ejecución). No hay ancho máximo de EN.
+#define US_DMA_SLOT             14
+#define DISPLAY_DMA_SLOTS       7       // Ranuras por byte
+#define DISPLAY_DMA_CODES       34      // Por ráfaga: cuadro 16x2 completo (32 datos + 2 direcciones)
+#define DISPLAY_DMA_WORDS       (DISPLAY_DMA_CODES * DISPLAY_DMA_SLOTS)
+#endif
+
+// Backend DISPLAY_CONNECTION_I2C: LCD detrás de un PCF8574 (pines en board.h).
+// Cada nibble son dos bytes del puerto del expansor, datos con EN alto y datos
+// con EN bajo; la ráfaga sale por I2C2 con DMA1 canal 4 y las interrupciones de
+// I2C2 solo atienden START, dirección y fin. 0 = sin I2C2, el backend cae a GPIO.
+#ifndef DISPLAY_CFG_I2C
+#define DISPLAY_CFG_I2C        (1)
+#endif
+
+#if (1 == DISPLAY_CFG_I2C)
+#define DISPLAY_I2C             I2C2
+#define DISPLAY_I2C_CH          DMA1_Channel4   // I2C2_TX
+#define DISPLAY_I2C_IFCR        DMA_IFCR_CGIF4
+#define DISPLAY_I2C_PCLK1       (SystemCoreClock / 2)   // APB1 = HCLK / 2
+#define DISPLAY_I2C_HZ          100000  // PCF8574: solo modo estándar
+#define DISPLAY_I2C_IRQ_PRIORITY 14     // Sobre PendSV (foreground), bajo SysTick y EXTI
+
+// A 100 kHz cada byte tarda 90 us: es el ancho de EN y la separación entre
+// comandos (> 37 us), así que solo Clear/Home y el arranque necesitan esperas
+#define DISPLAY_I2C_CODES       34      // Por ráfaga: cuadro 16x2 completo, como DMA
+#define DISPLAY_I2C_BYTES       (DISPLAY_I2C_CODES * 5)  // 4 por código + 1 si cambia RS
+#define MS_I2C_TIMEOUT          50      // Ráfaga sin terminar (bus colgado): se aborta
+#define MS_I2C_RETRY            100     // Tras un error (sin expansor): pausa antes de reintentar
+#define DISPLAY_I2C_CLEAR_PULSES 9      // SCL para que un esclavo a mitad de byte suelte SDA
+#endif
+
+typedef enum {
+    DISPLAY_ENGINE_IDLE,        // Sin código en curso
+    DISPLAY_ENGINE_NIBBLE_LOW,  // Nibble alto enviado, falta el bajo
+    DISPLAY_ENGINE_BUSY,        // Comando enviado, esperando BF = 0 (DISPLAY_CFG_BUSY_FLAG)
+    DISPLAY_ENGINE_DMA,         // Ráfaga en curso por TIM2 + DMA1
+    DISPLAY_ENGINE_I2C          // Ráfaga en curso por I2C2 + DMA1
+} displayEngineState_t;
 
 /* --- VARIABLES PRIVADAS --- */
-static bool initial8BitCommunicationIsCompleted = false;
+static displayConnection_t displayConnection;
+static uint8_t displayInitPending;          // Códigos de la secuencia de arranque sin enviar
+
+static uint16_t displayQueueBuffer[DISPLAY_QUEUE_SIZE];
+static ring_buffer_t displayQueue;          // Productor: displayStringWrite(), consumidor: displayUpdate()
+static displayEngineState_t displayEngineState;
+static uint16_t displayCode;                // Código en curso
+static uint32_t displayWaitStart;           // CYCCNT al iniciar la espera en curso
+static uint32_t displayWaitCycles;          // Duración de la espera en curso
+
+// Framebuffer: el renderer escribe en target, displayUpdate() envía solo las
+// celdas que difieren de shadow (lo que el LCD ya muestra o tiene encolado)
+static char displayTarget[DISPLAY_ROWS][DISPLAY_COLS];
+static char displayShadow[DISPLAY_ROWS][DISPLAY_COLS];
+static uint8_t displayCursorX;
+static uint8_t displayCursorY;
+static uint8_t displayAddr;                 // Contador de direcciones (AC) del HD44780
+static bool displayDirty;                   // target cambió desde el último diff
+
+// Bytes (comandos + datos) enviados por cuadro
+static struct {
+    uint32_t frames;
+    uint32_t bytes;
+    uint32_t bytesLast;
+    uint32_t bytesMax;
+} displayStats;
+
+#if (1 == DISPLAY_CFG_BUS_LUT)
+// [puerto][RS][nibble]: un store por puerto deja RS y D4..D7 en su valor
+static const uint32_t displayBusBsrr[2][2][16] = {
+    { LCD_BSRR_ROW(LCD_BUS_PORT0, 0), LCD_BSRR_ROW(LCD_BUS_PORT0, 1) },
+    { LCD_BSRR_ROW(LCD_BUS_PORT1, 0), LCD_BSRR_ROW(LCD_BUS_PORT1, 1) },
+};
+
+// RS, D5 y D6 tienen que estar en el puerto de D4 o en el de D7
+_Static_assert(((LCD_RS_PORT == LCD_BUS_PORT0) || (LCD_RS_PORT == LCD_BUS_PORT1)) &&
+               ((LCD_D5_PORT == LCD_BUS_PORT0) || (LCD_D5_PORT == LCD_BUS_PORT1)) &&
+               ((LCD_D6_PORT == LCD_BUS_PORT0) || (LCD_D6_PORT == LCD_BUS_PORT1)),
+               "LCD: RS/D4..D7 en mas de dos puertos");
+
+// [puerto][nibble bajo]: D0..D3 del bus de 8 bits
+static const uint32_t displayBusBsrrLow[2][16] = {
+    LCD_BSRR_LOW_ROW(LCD_BUS_PORT0), LCD_BSRR_LOW_ROW(LCD_BUS_PORT1),
+};
+
+_Static_assert(((LCD_D0_PORT == LCD_BUS_PORT0) || (LCD_D0_PORT == LCD_BUS_PORT1)) &&
+               ((LCD_D1_PORT == LCD_BUS_PORT0) || (LCD_D1_PORT == LCD_BUS_PORT1)) &&
+               ((LCD_D2_PORT == LCD_BUS_PORT0) || (LCD_D2_PORT == LCD_BUS_PORT1)) &&
+               ((LCD_D3_PORT == LCD_BUS_PORT0) || (LCD_D3_PORT == LCD_BUS_PORT1)),
+               "LCD: D0..D3 fuera de los puertos de D4 y D7");
+#endif
+
+// Costo de CPU de escribir un código en el bus (ciclos): en 4 bits los dos
+// nibbles con sus pulsos de EN y la pausa entre ellos, en 8 bits un solo pulso
+static profiler_dta_t displayBusProfile;
+static uint32_t displayBusStart;
+
+#if (1 == DISPLAY_CFG_DMA)
+// Palabras BSRR de la ráfaga en curso, una por ranura y por puerto
+static uint32_t displayDmaPort0[DISPLAY_DMA_WORDS];
+static uint32_t displayDmaPort1[DISPLAY_DMA_WORDS];
+
+// EN viaja en las palabras del puerto 0 (TIM2_UP)
+_Static_assert(LCD_EN_PORT == LCD_BUS_PORT0, "LCD: EN tiene que estar en el puerto de D4");
+
+static struct {
+    uint32_t bursts;
+    uint32_t codes;
+    uint32_t cycles;            // CPU armando ráfagas
+    uint32_t codesMax;
+} displayDmaStats;
+#endif
+
+#if (1 == DISPLAY_CFG_I2C)
+// Bytes del puerto del PCF8574 de la ráfaga en curso
+static uint8_t displayI2cBuffer[DISPLAY_I2C_BYTES];
+static uint8_t displayI2cPort;              // Último byte armado (RS y datos que quedan en el bus)
+static uint8_t displayI2cWaitMs;            // Espera tras la ráfaga (arranque, Clear/Home)
+static uint32_t displayI2cTick;             // HAL_GetTick() al arrancar la ráfaga
+static volatile bool displayI2cBusy;        // Ráfaga en curso, la baja la ISR
+static volatile bool displayI2cFailed;      // Ráfaga descartada: el LCD no muestra shadow
+static bool displayI2cInitDone;             // El expansor aceptó toda la secuencia de arranque
+
+static struct {
+    uint32_t bursts;
+    uint32_t codes;
+    uint32_t bytes;
+    uint32_t cycles;            // CPU armando ráfagas
+    uint32_t errors;            // NACK, error de bus o timeout
+} displayI2cStats;
+#endif
+
+#if (1 == DISPLAY_CFG_BUSY_FLAG)
+// Latencia real por comando: fin del nibble bajo -> BF = 0 (ciclos)
+static profiler_dta_t displayBusyProfile;
+static uint32_t displayBusyStart;
+static uint32_t displayBusyTimeouts;        // Tiempo fijo vencido con BF = 1
+
+// Dirección de los pines de datos para leer BF: máscara de CRL/CRH y valor de
+// cada dirección, por puerto del bus (0: el de D4, 1: el de D7). Se arman una
+// vez en displayInit(), así cada lectura es un store por registro sin HAL
+typedef struct {
+    uint32_t mask;
+    uint32_t input;                         // Entrada flotante (CNF = 01, MODE = 00)
+    uint32_t output;                        // Push-pull 50 MHz (CNF = 00, MODE = 11)
+} displayBusCr_t;
+
+static displayBusCr_t displayBusCr[2][2];   // [puerto][CRL, CRH]
+
+_Static_assert(((LCD_D5_PORT == LCD_D4_PORT) || (LCD_D5_PORT == LCD_D7_PORT)) &&
+               ((LCD_D6_PORT == LCD_D4_PORT) || (LCD_D6_PORT == LCD_D7_PORT)) &&
+               ((LCD_D0_PORT == LCD_D4_PORT) || (LCD_D0_PORT == LCD_D7_PORT)) &&
+               ((LCD_D1_PORT == LCD_D4_PORT) || (LCD_D1_PORT == LCD_D7_PORT)) &&
+               ((LCD_D2_PORT == LCD_D4_PORT) || (LCD_D2_PORT == LCD_D7_PORT)) &&
+               ((LCD_D3_PORT == LCD_D4_PORT) || (LCD_D3_PORT == LCD_D7_PORT)),
+               "LCD: D0..D7 fuera de los puertos de D4 y D7");
+#endif
 
 /* --- PROTOTIPOS --- */
 static void displayPinWrite(uint8_t pinName, int value);
-static void displayDataBusWrite(uint8_t dataByte);
-static void displayCodeWrite(bool type, uint8_t dataBus);
+static void displayNibbleWrite(bool type, uint8_t nibble);
+static void displayByteWrite(bool type, uint8_t dataBus);
+static void displayEnablePulse(void);
+static void displayBusLowDirection(uint32_t mode);
+static void displayCommandWait(void);
+static void displayInitQueue(void);
+static void displayCodeQueue(bool type, uint8_t dataBus);
+static void displayNibbleQueue(uint8_t dataBus, uint8_t waitMs);
+static void displayWait(uint32_t us);
+static bool displayWaitDone(void);
+static bool displayEngineStep(void);
+static void displayFrameDiff(void);
+#if (1 == DISPLAY_CFG_BUSY_FLAG)
+static void displayBusCrAdd(GPIO_TypeDef *port, uint16_t pin);
+static void displayBusDirection(bool input);
+static bool displayBusyRead(void);
 static void lcdFastDelay(uint32_t us);
+#endif
+static void lcdFastDelayCycles(uint32_t cycles);
+#if (1 == DISPLAY_CFG_DMA)
+static void displayDmaInit(void);
+static bool displayDmaStart(void);
+static void displayDmaStop(void);
+static void displayDmaUpdate(void);
+#endif
+#if (1 == DISPLAY_CFG_I2C)
+static void displayI2cInit(void);
+static void displayI2cReset(void);
+static bool displayI2cStart(void);
+static void displayI2cStop(void);
+static void displayI2cUpdate(void);
+#endif
 
 /* --- FUNCIONES PÚBLICAS --- */
 
 void displayInit(displayConnection_t connection)
 {
+    displayConnection = connection;
+
     // 1. Inicialización física de pines (Reset)
-    displayPinWrite(DISPLAY_PIN_RS, 0);
+#if (1 == DISPLAY_CFG_I2C)
+    if (DISPLAY_CONNECTION_I2C != displayConnection)
+#endif
+    {
+        displayPinWrite(DISPLAY_PIN_RS, 0);
+        displayPinWrite(DISPLAY_PIN_EN, 0);
+        displayPinWrite(DISPLAY_PIN_D4, 0);
+        displayPinWrite(DISPLAY_PIN_D5, 0);
+        displayPinWrite(DISPLAY_PIN_D6, 0);
+        displayPinWrite(DISPLAY_PIN_D7, 0);
+
+        // D0..D3 fuera de CubeMX: solo existen en el bus de 8 bits
+        if (DISPLAY_CONNECTION_GPIO_8BITS == displayConnection) {
+            displayPinWrite(DISPLAY_PIN_D0, 0);
+            displayPinWrite(DISPLAY_PIN_D1, 0);
+            displayPinWrite(DISPLAY_PIN_D2, 0);
+            displayPinWrite(DISPLAY_PIN_D3, 0);
+            displayBusLowDirection(GPIO_MODE_OUTPUT_PP);
+        }
+    }
+
+    // Motor asíncrono vacío: a partir de aquí las escrituras se encolan
+    ring_buffer_init(&displayQueue, displayQueueBuffer, DISPLAY_QUEUE_SIZE, sizeof(uint16_t));
+    displayEngineState = DISPLAY_ENGINE_IDLE;
+
+    // Espera inicial de encendido: corre como cualquier otra espera del motor
+    // (CYCCNT ya tiene que estar contando, ver app_init())
+    displayWait(MS_POWER_ON * 1000);
+
+    // Tras el Clear Display el LCD muestra espacios y AC = 0
+    memset(displayTarget, ' ', sizeof(displayTarget));
+    memset(displayShadow, ' ', sizeof(displayShadow));
+    displayCursorX = 0;
+    displayCursorY = 0;
+    displayAddr = DISPLAY_LINE1_ADDR;
+    displayDirty = false;
+    memset(&displayStats, 0, sizeof(displayStats));
+    profiler_reset(&displayBusProfile);
+
+#if (1 == DISPLAY_CFG_BUSY_FLAG)
+    {
+        GPIO_InitTypeDef GPIO_InitStruct = {0};
+
+        // RW fuera de CubeMX: solo existe en este modo
+        HAL_GPIO_WritePin(LCD_RW_PORT, LCD_RW_PIN, GPIO_PIN_RESET);
+        GPIO_InitStruct.Pin = LCD_RW_PIN;
+        GPIO_InitStruct.Mode = GPIO_MODE_OUTPUT_PP;
+        GPIO_InitStruct.Pull = GPIO_NOPULL;
+        GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_HIGH;
+        HAL_GPIO_Init(LCD_RW_PORT, &GPIO_InitStruct);
+
+        // Pines que el HD44780 maneja durante la lectura
+        memset(displayBusCr, 0, sizeof(displayBusCr));
+        displayBusCrAdd(LCD_D4_PORT, LCD_D4_PIN);
+        displayBusCrAdd(LCD_D5_PORT, LCD_D5_PIN);
+        displayBusCrAdd(LCD_D6_PORT, LCD_D6_PIN);
+        displayBusCrAdd(LCD_D7_PORT, LCD_D7_PIN);
+        if (DISPLAY_CONNECTION_GPIO_8BITS == displayConnection) {
+            displayBusCrAdd(LCD_D0_PORT, LCD_D0_PIN);
+            displayBusCrAdd(LCD_D1_PORT, LCD_D1_PIN);
+            displayBusCrAdd(LCD_D2_PORT, LCD_D2_PIN);
+            displayBusCrAdd(LCD_D3_PORT, LCD_D3_PIN);
+        }
+        displayBusDirection(false);
+
+        profiler_reset(&displayBusyProfile);
+        displayBusyTimeouts = 0;
+    }
+#endif
+
+    // La secuencia de arranque se encola y la envía displayUpdate() con sus
+    // esperas como plazos: displayInit() no bloquea
+    displayInitQueue();
+
+#if (1 == DISPLAY_CFG_DMA)
+    // El arranque va por la CPU (nibbles sueltos, esperas en ms); desde que
+    // termina, los cuadros van por DMA
+    if (DISPLAY_CONNECTION_GPIO_4BITS_DMA == displayConnection) {
+        displayDmaInit();
+    }
+#endif
+#if (1 == DISPLAY_CFG_I2C)
+    // Por I2C todo sale en ráfagas, también la secuencia de arranque
+    if (DISPLAY_CONNECTION_I2C == displayConnection) {
+        displayI2cInit();
+    }
+#endif
+}
+
+void displayCharPositionWrite(uint8_t x, uint8_t y)
+{
+    displayCursorX = x;
+    displayCursorY = (y > 0) ? 1 : 0;
+}
+
+void displayStringWrite(const char * str)
+{
+    char *cell;
+
+    // Lo que pasa de la columna 16 no es visible en el 16x2: se recorta
+    while (*str && (displayCursorX < DISPLAY_COLS)) {
+        cell = &displayTarget[displayCursorY][displayCursorX++];
+        if (*cell != *str) {
+            *cell = *str;
+            displayDirty = true;
+        }
+        str++;
+    }
+}
+
+/**
+ * @brief  Avanza el motor asíncrono: envía los nibbles pendientes cuya espera
+ * ya venció. Solo espera activamente las pausas cortas (entre nibbles, 2 us);
+ * el tiempo de ejecución del comando (37 us / 1.52 ms) se deja correr hasta la
+ * próxima llamada, así que cada llamada envía como mucho un byte.
+ */
+void displayUpdate(void)
+{
+#if (1 == DISPLAY_CFG_BUSY_FLAG)
+    uint32_t sliceStart = cycle_counter_get();
+#endif
+
+#if (1 == DISPLAY_CFG_DMA)
+    if ((DISPLAY_CONNECTION_GPIO_4BITS_DMA == displayConnection) && (0 == displayInitPending)) {
+        displayDmaUpdate();
+        return;
+    }
+#endif
+#if (1 == DISPLAY_CFG_I2C)
+    if (DISPLAY_CONNECTION_I2C == displayConnection) {
+        displayI2cUpdate();
+        return;
+    }
+#endif
+
+    // Cuadro anterior enviado: encolamos solo las celdas que cambiaron
+    if (displayDirty && ring_buffer_is_empty(&displayQueue) && (DISPLAY_ENGINE_IDLE == displayEngineState)) {
+        displayFrameDiff();
+    }
+
+    for (;;)
+    {
+        if (!displayWaitDone())
+        {
+#if (1 == DISPLAY_CFG_BUSY_FLAG)
+            if (DISPLAY_ENGINE_BUSY == displayEngineState)
+            {
+                if (!displayBusyRead()) {
+                    // Listo antes del tiempo fijo: seguimos con el próximo código
+                    profiler_add(&displayBusyProfile, cycle_counter_get() - displayBusyStart);
+                    displayEngineState = DISPLAY_ENGINE_IDLE;
+                    displayWaitCycles = 0;
+                }
+                else if (((cycle_counter_get() - sliceStart) >= (US_BF_SLICE * cycles_per_us)) ||
+                         (displayWaitCycles > (US_EXEC_STD * cycles_per_us))) {
+                    // Sin presupuesto, o Clear/Home (1.52 ms): se vuelve a leer en la próxima llamada
+                    return;
+                }
+                continue;
+            }
+#endif
+            // Tiempo de ejecución del comando: se deja correr hasta la próxima llamada
+            if (displayWaitCycles > (US_SPIN_MAX * cycles_per_us)) {
+                return;
+            }
+            continue;
+        }
+
+#if (1 == DISPLAY_CFG_BUSY_FLAG)
+        if (DISPLAY_ENGINE_BUSY == displayEngineState) {
+            // Venció el tiempo fijo con BF = 1: seguimos igual (fallback)
+            displayBusyTimeouts++;
+            displayEngineState = DISPLAY_ENGINE_IDLE;
+        }
+#endif
+
+        if (!displayEngineStep()) {
+            return;
+        }
+    }
+}
+
+bool displayGlyphDefine(uint8_t index, const uint8_t *pattern)
+{
+    uint8_t row;
+
+    if ((DISPLAY_QUEUE_SIZE - ring_buffer_count(&displayQueue)) < (1 + DISPLAY_GLYPH_ROWS)) {
+        return false;
+    }
+
+    displayCodeQueue(DISPLAY_RS_INSTRUCTION, DISPLAY_IR_SET_CGRAM_ADDR | ((index & 0x07) << 3));
+    for (row = 0; row < DISPLAY_GLYPH_ROWS; row++) {
+        displayCodeQueue(DISPLAY_RS_DATA, pattern[row] & 0x1F);
+    }
+
+    // El AC quedó apuntando a CGRAM: el próximo diff reposiciona en DDRAM
+    displayAddr = DISPLAY_ADDR_NONE;
+
+    return true;
+}
+
+bool displayFrameDone(void)
+{
+    return !displayDirty &&
+           ring_buffer_is_empty(&displayQueue) &&
+           (DISPLAY_ENGINE_IDLE == displayEngineState) &&
+           displayWaitDone();
+}
+
+void displayFlush(void)
+{
+    while (!displayFrameDone()) {
+        displayUpdate();
+    }
+}
+
+void displayLogStats(void)
+{
+    ring_buffer_log("COLA LCD", &displayQueue);
+    LOGGER_LOG("   bytes/cuadro media/max/ultimo: %lu/%lu/%lu (%lu cuadros)\r\n",
+               (0 < displayStats.frames) ? (displayStats.bytes / displayStats.frames) : 0ul,
+               displayStats.bytesMax, displayStats.bytesLast, displayStats.frames);
+#if (1 == DISPLAY_CFG_DMA)
+    if (DISPLAY_CONNECTION_GPIO_4BITS_DMA == displayConnection) {
+        LOGGER_LOG("   bus DMA: %lu ciclos CPU/caracter, %lu rafagas (max %lu)\r\n",
+                   (0 < displayDmaStats.codes) ? (displayDmaStats.cycles / displayDmaStats.codes) : 0ul,
+                   displayDmaStats.bursts, displayDmaStats.codesMax);
+        return;
+    }
+#endif
+#if (1 == DISPLAY_CFG_I2C)
+    if (DISPLAY_CONNECTION_I2C == displayConnection) {
+        LOGGER_LOG("   bus I2C: %lu ciclos CPU/caracter, %lu bytes/car\r\n",
+                   (0 < displayI2cStats.codes) ? (displayI2cStats.cycles / displayI2cStats.codes) : 0ul,
+                   (0 < displayI2cStats.codes) ? (displayI2cStats.bytes / displayI2cStats.codes) : 0ul);
+        LOGGER_LOG("   %lu rafagas, %lu errores\r\n", displayI2cStats.bursts, displayI2cStats.errors);
+        return;
+    }
+#endif
+    LOGGER_LOG("   bus %s %s: %lu ciclos/car, %lu ciclos/cuadro\r\n",
+               (1 == DISPLAY_CFG_BUS_LUT) ? "BSRR" : "HAL",
+               (DISPLAY_CONNECTION_GPIO_8BITS == displayConnection) ? "8 bits" : "4 bits",
+               profiler_mean(&displayBusProfile),
+               (0 < displayStats.frames) ?
+                   (profiler_mean(&displayBusProfile) * (displayStats.bytes / displayStats.frames)) : 0ul);
+#if (1 == DISPLAY_CFG_BUSY_FLAG)
+    LOGGER_LOG("   BF min/med/max %lu/%lu/%lu cic (%lu cmd), tout %lu\r\n",
+               (0 < displayBusyProfile.cnt) ? displayBusyProfile.min : 0ul,
+               profiler_mean(&displayBusyProfile), displayBusyProfile.max,
+               displayBusyProfile.cnt, displayBusyTimeouts);
+#endif
+}
+
+void displayI2cEventIrq(void)
+{
+#if (1 == DISPLAY_CFG_I2C)
+    uint32_t sr1 = DISPLAY_I2C->SR1;
+
+    if (sr1 & I2C_SR1_SB) {
+        // EV5: leer SR1 y escribir DR borra SB
+        DISPLAY_I2C->DR = LCD_I2C_ADDR << 1;
+    } else if (sr1 & I2C_SR1_ADDR) {
+        // EV6: leer SR1 y SR2 borra ADDR; desde acá el DMA carga DR en cada TXE
+        (void)DISPLAY_I2C->SR2;
+    } else if (sr1 & I2C_SR1_BTF) {
+        // EV8_2: el DMA ya no carga DR (CNDTR = 0) y el último byte salió
+        displayI2cStop();
+    }
+#endif
+}
+
+void displayI2cErrorIrq(void)
+{
+#if (1 == DISPLAY_CFG_I2C)
+    // NACK (sin expansor), error de bus o arbitraje perdido: se descarta la ráfaga
+    DISPLAY_I2C->SR1 &= ~(I2C_SR1_AF | I2C_SR1_BERR | I2C_SR1_ARLO | I2C_SR1_OVR);
+    displayI2cStats.errors++;
+    displayI2cFailed = true;
+    displayI2cStop();
+#endif
+}
+
+/* --- FUNCIONES PRIVADAS OPTIMIZADAS --- */
+
+/**
+ * @brief  Compara target con shadow y encola las celdas distintas. Solo inserta
+ * SET_DDRAM_ADDR cuando la celda no es la siguiente al contador AC del LCD.
+ * Peor caso (celdas alternadas): 32 direcciones + 32 datos = DISPLAY_QUEUE_SIZE.
+ */
+static void displayFrameDiff(void)
+{
+    uint8_t x;
+    uint8_t y;
+    uint8_t addr;
+    uint32_t bytes = 0;
+
+    displayDirty = false;
+
+    for (y = 0; y < DISPLAY_ROWS; y++) {
+        for (x = 0; x < DISPLAY_COLS; x++) {
+            if (displayTarget[y][x] == displayShadow[y][x]) {
+                continue;
+            }
+
+            addr = ((y > 0) ? DISPLAY_LINE2_ADDR : DISPLAY_LINE1_ADDR) + x;
+            if (addr != displayAddr) {
+                displayCodeQueue(DISPLAY_RS_INSTRUCTION, DISPLAY_IR_SET_DDRAM_ADDR | addr);
+                bytes++;
+            }
+
+            displayCodeQueue(DISPLAY_RS_DATA, (uint8_t)displayTarget[y][x]);
+            displayShadow[y][x] = displayTarget[y][x];
+            displayAddr = addr + 1;
+            bytes++;
+        }
+    }
+
+    if (0 < bytes) {
+        displayStats.frames++;
+        displayStats.bytes += bytes;
+        displayStats.bytesLast = bytes;
+        if (displayStats.bytesMax < bytes) {
+            displayStats.bytesMax = bytes;
+        }
+    }
+}
+
+#if (1 == DISPLAY_CFG_BUSY_FLAG)
+/**
+ * @brief  lcdFastDelayCycles() en us, para la lectura del busy flag
+ */
+static void lcdFastDelay(uint32_t us)
+{
+    lcdFastDelayCycles(us * (SystemCoreClock / 1000000));
+}
+#endif
+
+/**
+ * @brief  Retardo híbrido: Usa DWT si está activo, o HAL_Delay (ms) si no.
+ * Solo cubre los tiempos del pulso de EN; las esperas largas son plazos del motor.
+ */
+static void lcdFastDelayCycles(uint32_t cycles)
+{
+    // Verificamos si el contador de ciclos DWT está habilitado
+    if (DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk)
+    {
+        uint32_t start = DWT->CYCCNT;
+        while ((DWT->CYCCNT - start) < cycles);
+    }
+    else
+    {
+        // Fallback seguro para inicialización (mínimo 1ms)
+        uint32_t ms = cycles / (SystemCoreClock / 1000);
+        if (ms == 0 && cycles > 0) ms = 1;
+        HAL_Delay(ms);
+    }
+}
+
+/**
+ * @brief  Un nibble en D7..D4 (con RS) y su pulso de EN
+ */
+static void displayNibbleWrite(bool type, uint8_t nibble)
+{
+#if (1 == DISPLAY_CFG_BUS_LUT)
+    // Un store por puerto: RS y D4..D7 cambian juntos, sin lectura-modificación
+    LCD_BUS_PORT0->BSRR = displayBusBsrr[0][type][nibble & 0x0F];
+    if (LCD_BUS_SPLIT) {
+        LCD_BUS_PORT1->BSRR = displayBusBsrr[1][type][nibble & 0x0F];
+    }
+#else
+    displayPinWrite(DISPLAY_PIN_RS, type);
+    displayPinWrite(DISPLAY_PIN_D7, (nibble & 0x08) >> 3);
+    displayPinWrite(DISPLAY_PIN_D6, (nibble & 0x04) >> 2);
+    displayPinWrite(DISPLAY_PIN_D5, (nibble & 0x02) >> 1);
+    displayPinWrite(DISPLAY_PIN_D4, (nibble & 0x01));
+#endif
+
+    displayEnablePulse();
+}
+
+/**
+ * @brief  Un byte en D7..D0 (con RS) y un solo pulso de EN (bus de 8 bits)
+ */
+static void displayByteWrite(bool type, uint8_t dataBus)
+{
+#if (1 == DISPLAY_CFG_BUS_LUT)
+    // Igual que un nibble: un store por puerto, con D0..D3 sumados por OR
+    LCD_BUS_PORT0->BSRR = displayBusBsrr[0][type][dataBus >> 4] | displayBusBsrrLow[0][dataBus & 0x0F];
+    if (LCD_BUS_SPLIT) {
+        LCD_BUS_PORT1->BSRR = displayBusBsrr[1][type][dataBus >> 4] | displayBusBsrrLow[1][dataBus & 0x0F];
+    }
+#else
+    displayPinWrite(DISPLAY_PIN_RS, type);
+    displayPinWrite(DISPLAY_PIN_D7, (dataBus & 0x80) >> 7);
+    displayPinWrite(DISPLAY_PIN_D6, (dataBus & 0x40) >> 6);
+    displayPinWrite(DISPLAY_PIN_D5, (dataBus & 0x20) >> 5);
+    displayPinWrite(DISPLAY_PIN_D4, (dataBus & 0x10) >> 4);
+    displayPinWrite(DISPLAY_PIN_D3, (dataBus & 0x08) >> 3);
+    displayPinWrite(DISPLAY_PIN_D2, (dataBus & 0x04) >> 2);
+    displayPinWrite(DISPLAY_PIN_D1, (dataBus & 0x02) >> 1);
+    displayPinWrite(DISPLAY_PIN_D0, (dataBus & 0x01));
+#endif
+
+    displayEnablePulse();
+}
+
+/**
+ * @brief  Pulso de EN con los datos ya en el bus: el HD44780 los toma al bajar
+ */
+static void displayEnablePulse(void)
+{
+    lcdFastDelayCycles(CYC_EN_SETUP);
+#if (1 == DISPLAY_CFG_BUS_LUT)
+    LCD_EN_PORT->BSRR = LCD_EN_PIN;
+    lcdFastDelayCycles(CYC_EN_PULSE);
+    LCD_EN_PORT->BSRR = (uint32_t)LCD_EN_PIN << 16;
+#else
+    displayPinWrite(DISPLAY_PIN_EN, 1);
+    lcdFastDelayCycles(CYC_EN_PULSE);
     displayPinWrite(DISPLAY_PIN_EN, 0);
-    displayPinWrite(DISPLAY_PIN_D4, 0);
-    displayPinWrite(DISPLAY_PIN_D5, 0);
-    displayPinWrite(DISPLAY_PIN_D6, 0);
-    displayPinWrite(DISPLAY_PIN_D7, 0);
+#endif
+}
 
-    // Espera inicial de encendido
-    HAL_Delay(50);
+/**
+ * @brief  Encola un código para el motor asíncrono (retorna inmediatamente)
+ */
+static void displayCodeQueue(bool type, uint8_t dataBus)
+{
+    uint16_t code = dataBus;
 
-    initial8BitCommunicationIsCompleted = false;
+    if (type == DISPLAY_RS_DATA) {
+        code |= DISPLAY_CODE_RS;
+    }
 
-    //
-    displayCodeWrite(DISPLAY_RS_INSTRUCTION, DISPLAY_IR_FUNCTION_SET | DISPLAY_IR_FUNCTION_SET_8BITS);
-    HAL_Delay(5);
+    // Cola llena: el código se descarta y se cuenta en overflow_cnt
+    ring_buffer_put(&displayQueue, &code);
+}
 
-    displayCodeWrite(DISPLAY_RS_INSTRUCTION, DISPLAY_IR_FUNCTION_SET | DISPLAY_IR_FUNCTION_SET_8BITS);
-    HAL_Delay(1);
+/**
+ * @brief  Encola un nibble suelto del arranque en 8 bits (el alto de dataBus)
+ * y la espera en ms que le sigue
+ */
+static void displayNibbleQueue(uint8_t dataBus, uint8_t waitMs)
+{
+    uint16_t code = DISPLAY_CODE_NIBBLE | (dataBus & 0xF0) | (waitMs & 0x0F);
+
+    ring_buffer_put(&displayQueue, &code);
+}
+
+static void displayWait(uint32_t us)
+{
+    displayWaitStart = cycle_counter_get();
+    displayWaitCycles = us * cycles_per_us;
+}
+
+static bool displayWaitDone(void)
+{
+    // Resta sin signo: válida aunque CYCCNT dé la vuelta
+    return ((cycle_counter_get() - displayWaitStart) >= displayWaitCycles);
+}
 
-    displayCodeWrite(DISPLAY_RS_INSTRUCTION, DISPLAY_IR_FUNCTION_SET | DISPLAY_IR_FUNCTION_SET_8BITS);
-    HAL_Delay(1);
+/**
+ * @brief  Encola la secuencia de arranque del HD44780 (reset por instrucción y
+ * configuración). La llama displayInit() y, por I2C, cada reintento tras un
+ * error antes de que el arranque termine.
+ */
+static void displayInitQueue(void)
+{
+    uint8_t functionSet;
 
-    // --- Pasar a 4 bits ---
-    displayCodeWrite(DISPLAY_RS_INSTRUCTION, DISPLAY_IR_FUNCTION_SET | DISPLAY_IR_FUNCTION_SET_4BITS);
-    HAL_Delay(1);
+    // Reset por instrucción, todavía en 8 bits (un solo nibble por comando;
+    // en el bus de 8 bits D0..D3 quedan en 0)
+    displayNibbleQueue(DISPLAY_IR_FUNCTION_SET | DISPLAY_IR_FUNCTION_SET_8BITS, 5);
+    displayNibbleQueue(DISPLAY_IR_FUNCTION_SET | DISPLAY_IR_FUNCTION_SET_8BITS, 1);
+    displayNibbleQueue(DISPLAY_IR_FUNCTION_SET | DISPLAY_IR_FUNCTION_SET_8BITS, 1);
 
-    // ---  MODO 4 BITS ---
-    initial8BitCommunicationIsCompleted = true;
+    if (DISPLAY_CONNECTION_GPIO_8BITS == displayConnection) {
+        // --- MODO 8 BITS: ya está, cada byte sale con un solo pulso ---
+        functionSet = DISPLAY_IR_FUNCTION_SET_8BITS;
+    } else {
+        // --- Pasar a 4 bits ---
+        displayNibbleQueue(DISPLAY_IR_FUNCTION_SET | DISPLAY_IR_FUNCTION_SET_4BITS, 1);
+        functionSet = DISPLAY_IR_FUNCTION_SET_4BITS;
+    }
 
-    // Configurar: 4 bits, 2 líneas, fuente 5x8
-    displayCodeWrite(DISPLAY_RS_INSTRUCTION,
+    // Configurar: ancho de bus, 2 líneas, fuente 5x8
+    displayCodeQueue(DISPLAY_RS_INSTRUCTION,
                      DISPLAY_IR_FUNCTION_SET |
-                     DISPLAY_IR_FUNCTION_SET_4BITS |
+                     functionSet |
                      DISPLAY_IR_FUNCTION_SET_2LINES |
                      DISPLAY_IR_FUNCTION_SET_5x8DOTS);
 
     // Apagar display
-    displayCodeWrite(DISPLAY_RS_INSTRUCTION,
+    displayCodeQueue(DISPLAY_RS_INSTRUCTION,
                      DISPLAY_IR_DISPLAY_CONTROL |
                      DISPLAY_IR_DISPLAY_CONTROL_DISPLAY_OFF);
 
-    // Limpiar pantalla
-    displayCodeWrite(DISPLAY_RS_INSTRUCTION, DISPLAY_IR_CLEAR_DISPLAY);
-    HAL_Delay(MS_EXEC_CLEAR);
+    // Limpiar pantalla (el motor espera 1.52 ms)
+    displayCodeQueue(DISPLAY_RS_INSTRUCTION, DISPLAY_IR_CLEAR_DISPLAY);
 
     // Modo de entrada
-    displayCodeWrite(DISPLAY_RS_INSTRUCTION,
+    displayCodeQueue(DISPLAY_RS_INSTRUCTION,
                      DISPLAY_IR_ENTRY_MODE_SET |
                      DISPLAY_IR_ENTRY_MODE_SET_INCREMENT |
                      DISPLAY_IR_ENTRY_MODE_SET_NO_SHIFT);
 
     // Encender display
-    displayCodeWrite(DISPLAY_RS_INSTRUCTION,
+    displayCodeQueue(DISPLAY_RS_INSTRUCTION,
                      DISPLAY_IR_DISPLAY_CONTROL |
                      DISPLAY_IR_DISPLAY_CONTROL_DISPLAY_ON |
                      DISPLAY_IR_DISPLAY_CONTROL_CURSOR_OFF |
                      DISPLAY_IR_DISPLAY_CONTROL_BLINK_OFF);
+
+    displayInitPending = (uint8_t)ring_buffer_count(&displayQueue);
 }
 
-void displayCharPositionWrite(uint8_t x, uint8_t y)
+/**
+ * @brief  Código completo en el bus: arranca su tiempo de ejecución
+ */
+static void displayCommandWait(void)
 {
-    uint8_t addr = DISPLAY_LINE1_ADDR;
-    if (y > 0) addr = DISPLAY_LINE2_ADDR;
-    addr += x;
-    displayCodeWrite(DISPLAY_RS_INSTRUCTION, DISPLAY_IR_SET_DDRAM_ADDR | addr);
+    if (0 < displayInitPending) {
+        displayInitPending--;
+    }
+
+    // Clear Display / Return Home tardan 1.52 ms, el resto 37 us
+    if (!(displayCode & DISPLAY_CODE_RS) && ((uint8_t)displayCode <= 0x03)) {
+        displayWait(MS_EXEC_CLEAR * 1000);
+    } else {
+        displayWait(US_EXEC_STD);
+    }
+#if (1 == DISPLAY_CFG_BUSY_FLAG)
+    // El tiempo fijo queda como timeout: BF decide cuándo seguir
+    displayBusyStart = cycle_counter_get();
+    displayEngineState = DISPLAY_ENGINE_BUSY;
+#else
+    displayEngineState = DISPLAY_ENGINE_IDLE;
+#endif
 }
 
-void displayStringWrite(const char * str)
+/**
+ * @brief  Envía un nibble o un byte del código en curso (o toma el siguiente de la cola)
+ * @retval true si escribió el bus
+ */
+static bool displayEngineStep(void)
 {
-    while (*str) {
-        displayCodeWrite(DISPLAY_RS_DATA, *str++);
+    switch (displayEngineState)
+    {
+        case DISPLAY_ENGINE_IDLE:
+            if (!ring_buffer_get(&displayQueue, &displayCode)) {
+                return false;
+            }
+
+            if (displayCode & DISPLAY_CODE_NIBBLE) {
+                // Arranque en 8 bits: D7..D4 son el bus entero, un solo pulso
+                displayNibbleWrite(DISPLAY_RS_INSTRUCTION, (uint8_t)(displayCode >> 4) & 0x0F);
+                displayWait((displayCode & 0x0F) * 1000);
+                displayInitPending--;
+                return true;
+            }
+
+            displayBusStart = profiler_start();
+
+            if (DISPLAY_CONNECTION_GPIO_8BITS == displayConnection) {
+                // Bus de 8 bits: el byte entero con un solo pulso, sin pausa entre nibbles
+                displayByteWrite((displayCode & DISPLAY_CODE_RS) ? DISPLAY_RS_DATA : DISPLAY_RS_INSTRUCTION,
+                                 (uint8_t)displayCode);
+                profiler_stop(&displayBusProfile, displayBusStart);
+                displayCommandWait();
+                return true;
+            }
+
+            displayNibbleWrite((displayCode & DISPLAY_CODE_RS) ? DISPLAY_RS_DATA : DISPLAY_RS_INSTRUCTION,
+                               (uint8_t)(displayCode >> 4) & 0x0F);
+            displayWait(US_INTER_NIBBLE);
+            displayEngineState = DISPLAY_ENGINE_NIBBLE_LOW;
+            return true;
+
+        case DISPLAY_ENGINE_NIBBLE_LOW:
+            // Misma llamada a displayUpdate() que el nibble alto (la pausa se espera activamente)
+            displayNibbleWrite((displayCode & DISPLAY_CODE_RS) ? DISPLAY_RS_DATA : DISPLAY_RS_INSTRUCTION,
+                               (uint8_t)displayCode & 0x0F);
+            profiler_stop(&displayBusProfile, displayBusStart);
+            displayCommandWait();
+            return true;
+
+        default:
+            displayEngineState = DISPLAY_ENGINE_IDLE;
+            return false;
     }
 }
 
-/* --- FUNCIONES PRIVADAS OPTIMIZADAS --- */
+#if (1 == DISPLAY_CFG_DMA)
+/**
+ * @brief  TIM2 a 1 MHz con período de una ranura y los dos canales de DMA1
+ * apuntando al BSRR de cada puerto (memoria -> periférico, 32 bits)
+ */
+static void displayDmaInit(void)
+{
+    RCC->APB1ENR |= RCC_APB1ENR_TIM2EN;
+    RCC->AHBENR |= RCC_AHBENR_DMA1EN;
+    (void)RCC->AHBENR;
+
+    // APB1 = HCLK / 2, así que el reloj de TIM2 se duplica: HCLK (SystemClock_Config)
+    DISPLAY_DMA_TIM->CR1 = 0;
+    DISPLAY_DMA_TIM->DIER = 0;
+    DISPLAY_DMA_TIM->PSC = (SystemCoreClock / 1000000) - 1;
+    DISPLAY_DMA_TIM->ARR = US_DMA_SLOT - 1;
+    DISPLAY_DMA_TIM->CCR1 = US_DMA_SLOT / 2;
+    DISPLAY_DMA_TIM->EGR = TIM_EGR_UG;      // Carga PSC, sin pedido de DMA (UDE = 0)
+    DISPLAY_DMA_TIM->SR = 0;
+
+    DISPLAY_DMA_CH_PORT0->CCR = 0;
+    DISPLAY_DMA_CH_PORT0->CPAR = (uintptr_t)&LCD_BUS_PORT0->BSRR;
+    DISPLAY_DMA_CH_PORT0->CMAR = (uintptr_t)displayDmaPort0;
+    DISPLAY_DMA_CH_PORT0->CCR = DMA_CCR_MINC | DMA_CCR_DIR | DMA_CCR_PSIZE_1 | DMA_CCR_MSIZE_1 | DMA_CCR_PL_1;
+
+    DISPLAY_DMA_CH_PORT1->CCR = 0;
+    DISPLAY_DMA_CH_PORT1->CPAR = (uintptr_t)&LCD_BUS_PORT1->BSRR;
+    DISPLAY_DMA_CH_PORT1->CMAR = (uintptr_t)displayDmaPort1;
+    DISPLAY_DMA_CH_PORT1->CCR = DMA_CCR_MINC | DMA_CCR_DIR | DMA_CCR_PSIZE_1 | DMA_CCR_MSIZE_1 | DMA_CCR_PL_1;
+
+    DMA1->IFCR = DISPLAY_DMA_IFCR;
+    memset(&displayDmaStats, 0, sizeof(displayDmaStats));
+}
 
 /**
- * @brief  Retardo híbrido: Usa DWT (us) si está activo, o HAL_Delay (ms) si no.
- * Esto asegura que funcione en displayInit() y vuele en displayStringWrite().
+ * @brief  Arma la ráfaga con los códigos encolados (hasta un cuadro completo) y
+ * arranca el timer. Clear/Home cierra la ráfaga: sus 1.52 ms se esperan aparte.
+ * Puerto 1 se escribe media ranura antes que puerto 0 (CC1 antes del update),
+ * así D6/D7 ya están cuando sube EN y cambian recién después de que baja.
+ * @retval true si arrancó una ráfaga
  */
-static void lcdFastDelay(uint32_t us)
+static bool displayDmaStart(void)
 {
-    // Verificamos si el contador de ciclos DWT está habilitado
-    if (DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk)
-    {
-        uint32_t start = DWT->CYCCNT;
-        uint32_t cycles = us * (SystemCoreClock / 1000000);
-        while ((DWT->CYCCNT - start) < cycles);
+    uint32_t start = cycle_counter_get();
+    uint32_t words = 0;
+    uint32_t codes = 0;
+    uint8_t nibble;
+    bool type;
+    uint8_t i;
+
+    while ((codes < DISPLAY_DMA_CODES) && ring_buffer_get(&displayQueue, &displayCode)) {
+        type = (displayCode & DISPLAY_CODE_RS) ? DISPLAY_RS_DATA : DISPLAY_RS_INSTRUCTION;
+
+        for (i = 0; i < 2; i++) {
+            nibble = (0 == i) ? ((uint8_t)(displayCode >> 4) & 0x0F) : ((uint8_t)displayCode & 0x0F);
+
+            displayDmaPort0[words] = displayBusBsrr[0][type][nibble];
+            displayDmaPort1[words++] = LCD_BUS_SPLIT ? displayBusBsrr[1][type][nibble] : 0;
+            displayDmaPort0[words] = LCD_EN_PIN;
+            displayDmaPort1[words++] = 0;
+            displayDmaPort0[words] = (uint32_t)LCD_EN_PIN << 16;
+            displayDmaPort1[words++] = 0;
+        }
+
+        // Ranura libre: tiempo de ejecución del byte
+        displayDmaPort0[words] = 0;
+        displayDmaPort1[words++] = 0;
+        codes++;
+
+        if (!(displayCode & DISPLAY_CODE_RS) && ((uint8_t)displayCode <= 0x03)) {
+            break;
+        }
     }
-    else
-    {
-        // Fallback seguro para inicialización (mínimo 1ms)
-        uint32_t ms = us / 1000;
-        if (ms == 0 && us > 0) ms = 1;
-        HAL_Delay(ms);
+
+    if (0 == codes) {
+        return false;
     }
+
+    DISPLAY_DMA_CH_PORT0->CNDTR = words;
+    DISPLAY_DMA_CH_PORT0->CCR |= DMA_CCR_EN;
+    if (LCD_BUS_SPLIT) {
+        DISPLAY_DMA_CH_PORT1->CNDTR = words;
+        DISPLAY_DMA_CH_PORT1->CCR |= DMA_CCR_EN;
+    }
+
+    DISPLAY_DMA_TIM->CNT = 0;
+    DISPLAY_DMA_TIM->SR = 0;
+    DISPLAY_DMA_TIM->DIER = TIM_DIER_UDE | (LCD_BUS_SPLIT ? TIM_DIER_CC1DE : 0);
+    DISPLAY_DMA_TIM->CR1 = TIM_CR1_CEN;
+
+    displayDmaStats.bursts++;
+    displayDmaStats.codes += codes;
+    displayDmaStats.cycles += cycle_counter_get() - start;
+    if (displayDmaStats.codesMax < codes) {
+        displayDmaStats.codesMax = codes;
+    }
+
+    return true;
+}
+
+static void displayDmaStop(void)
+{
+    DISPLAY_DMA_TIM->CR1 = 0;
+    DISPLAY_DMA_TIM->DIER = 0;
+    DISPLAY_DMA_CH_PORT0->CCR &= ~DMA_CCR_EN;
+    DISPLAY_DMA_CH_PORT1->CCR &= ~DMA_CCR_EN;
+    DMA1->IFCR = DISPLAY_DMA_IFCR;
+}
+
+/**
+ * @brief  displayUpdate() del backend DMA: no toca el bus, solo detecta el fin
+ * de la ráfaga (CNDTR del puerto 0 en 0, su última palabra sale al final) y
+ * arma la siguiente cuando venció la espera del último código
+ */
+static void displayDmaUpdate(void)
+{
+    if (DISPLAY_ENGINE_DMA == displayEngineState) {
+        if (0 != DISPLAY_DMA_CH_PORT0->CNDTR) {
+            return;
+        }
+
+        displayDmaStop();
+        if (!(displayCode & DISPLAY_CODE_RS) && ((uint8_t)displayCode <= 0x03)) {
+            displayWait(MS_EXEC_CLEAR * 1000);
+        } else {
+            displayWait(US_EXEC_STD);
+        }
+        displayEngineState = DISPLAY_ENGINE_IDLE;
+    }
+
+    if (displayDirty && ring_buffer_is_empty(&displayQueue)) {
+        displayFrameDiff();
+    }
+
+    if (displayWaitDone() && displayDmaStart()) {
+        displayEngineState = DISPLAY_ENGINE_DMA;
+    }
+}
+#endif
+
+#if (1 == DISPLAY_CFG_I2C)
+/**
+ * @brief  I2C2 maestro a 100 kHz en PB10/PB11 y DMA1 canal 4 de memoria a I2C2_DR
+ * (8 bits). Las interrupciones de evento y error quedan habilitadas en el NVIC;
+ * cada ráfaga las habilita en I2C2 (ITEVTEN/ITERREN) mientras dura.
+ */
+static void displayI2cInit(void)
+{
+    RCC->APB1ENR |= RCC_APB1ENR_I2C2EN;
+    RCC->AHBENR |= RCC_AHBENR_DMA1EN;
+    (void)RCC->APB1ENR;
+
+    displayI2cReset();
+
+    DISPLAY_I2C_CH->CCR = 0;
+    DISPLAY_I2C_CH->CPAR = (uintptr_t)&DISPLAY_I2C->DR;
+    DISPLAY_I2C_CH->CMAR = (uintptr_t)displayI2cBuffer;
+    DISPLAY_I2C_CH->CCR = DMA_CCR_MINC | DMA_CCR_DIR | DMA_CCR_PL_1;
+    DMA1->IFCR = DISPLAY_I2C_IFCR;
+
+    HAL_NVIC_SetPriority(I2C2_EV_IRQn, DISPLAY_I2C_IRQ_PRIORITY, 0);
+    HAL_NVIC_EnableIRQ(I2C2_EV_IRQn);
+    HAL_NVIC_SetPriority(I2C2_ER_IRQn, DISPLAY_I2C_IRQ_PRIORITY, 0);
+    HAL_NVIC_EnableIRQ(I2C2_ER_IRQn);
+
+    displayI2cPort = LCD_I2C_BIT_BL;
+    displayI2cBusy = false;
+    displayI2cFailed = false;
+    displayI2cInitDone = false;
+    memset(&displayI2cStats, 0, sizeof(displayI2cStats));
 }
 
 /**
- * @brief  Envío inteligente de datos con tiempos mínimos usando lcdFastDelay
+ * @brief  SWRST de I2C2 y liberación del bus: si un esclavo quedó a mitad de
+ * byte reteniendo SDA, hasta 9 pulsos de SCL por GPIO y un STOP. Sin el SWRST
+ * un bus colgado deja BUSY en 1 y cada ráfaga vence por timeout.
  */
-static void displayDataBusWrite(uint8_t dataBus)
+static void displayI2cReset(void)
 {
-    // 1. Enviar Nibble Alto (Bits 7-4)
+    GPIO_InitTypeDef GPIO_InitStruct = {0};
+    uint32_t halfBit = SystemCoreClock / (2 * DISPLAY_I2C_HZ);
+    uint8_t i;
+
+    DISPLAY_I2C->CR1 = I2C_CR1_SWRST;
+
+    // SCL/SDA como GPIO open drain, en reposo (alto)
+    HAL_GPIO_WritePin(LCD_I2C_SCL_PORT, LCD_I2C_SCL_PIN, GPIO_PIN_SET);
+    HAL_GPIO_WritePin(LCD_I2C_SDA_PORT, LCD_I2C_SDA_PIN, GPIO_PIN_SET);
+    GPIO_InitStruct.Mode = GPIO_MODE_OUTPUT_OD;
+    GPIO_InitStruct.Pull = GPIO_NOPULL;
+    GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_HIGH;
+    GPIO_InitStruct.Pin = LCD_I2C_SCL_PIN;
+    HAL_GPIO_Init(LCD_I2C_SCL_PORT, &GPIO_InitStruct);
+    GPIO_InitStruct.Pin = LCD_I2C_SDA_PIN;
+    HAL_GPIO_Init(LCD_I2C_SDA_PORT, &GPIO_InitStruct);
+
+    for (i = 0; (i < DISPLAY_I2C_CLEAR_PULSES) &&
+                (GPIO_PIN_RESET == HAL_GPIO_ReadPin(LCD_I2C_SDA_PORT, LCD_I2C_SDA_PIN)); i++) {
+        HAL_GPIO_WritePin(LCD_I2C_SCL_PORT, LCD_I2C_SCL_PIN, GPIO_PIN_RESET);
+        lcdFastDelayCycles(halfBit);
+        HAL_GPIO_WritePin(LCD_I2C_SCL_PORT, LCD_I2C_SCL_PIN, GPIO_PIN_SET);
+        lcdFastDelayCycles(halfBit);
+    }
+
+    // STOP: SDA sube con SCL alto
+    HAL_GPIO_WritePin(LCD_I2C_SDA_PORT, LCD_I2C_SDA_PIN, GPIO_PIN_RESET);
+    lcdFastDelayCycles(halfBit);
+    HAL_GPIO_WritePin(LCD_I2C_SDA_PORT, LCD_I2C_SDA_PIN, GPIO_PIN_SET);
+    lcdFastDelayCycles(halfBit);
+
+    // SCL/SDA: función alternativa open drain (pull-ups en el backpack)
+    GPIO_InitStruct.Mode = GPIO_MODE_AF_OD;
+    GPIO_InitStruct.Pin = LCD_I2C_SCL_PIN;
+    HAL_GPIO_Init(LCD_I2C_SCL_PORT, &GPIO_InitStruct);
+    GPIO_InitStruct.Pin = LCD_I2C_SDA_PIN;
+    HAL_GPIO_Init(LCD_I2C_SDA_PORT, &GPIO_InitStruct);
+
+    DISPLAY_I2C->CR1 = 0;
+    DISPLAY_I2C->CR2 = DISPLAY_I2C_PCLK1 / 1000000;                 // FREQ en MHz
+    DISPLAY_I2C->CCR = DISPLAY_I2C_PCLK1 / (2 * DISPLAY_I2C_HZ);    // Modo estándar, SCL 1:1
+    DISPLAY_I2C->TRISE = (DISPLAY_I2C_PCLK1 / 1000000) + 1;         // tr máx. 1000 ns
+    DISPLAY_I2C->CR1 = I2C_CR1_PE;
+}
+
+/**
+ * @brief  Arma la ráfaga con los códigos encolados (hasta un cuadro completo) y
+ * pide el START; el resto lo hacen la ISR y el DMA. RS cambia un byte antes del
+ * pulso de EN (tAS), los datos cambian junto con EN alto y se mantienen al bajar.
+ * Los nibbles sueltos del arranque y Clear/Home cierran la ráfaga con su espera.
+ * @retval true si arrancó una ráfaga
+ */
+static bool displayI2cStart(void)
+{
+    uint32_t start = cycle_counter_get();
+    uint32_t bytes = 0;
+    uint32_t codes = 0;
+    uint8_t rs;
+    uint8_t nibble;
+    uint8_t i;
+
+    displayI2cWaitMs = 0;
+
+    while ((codes < DISPLAY_I2C_CODES) && ring_buffer_get(&displayQueue, &displayCode)) {
+        rs = (displayCode & DISPLAY_CODE_RS) ? LCD_I2C_BIT_RS : 0;
+
+        if ((displayI2cPort & LCD_I2C_BIT_RS) != rs) {
+            displayI2cPort = (displayI2cPort & ~LCD_I2C_BIT_RS) | rs;
+            displayI2cBuffer[bytes++] = displayI2cPort;
+        }
+
+        for (i = 0; i < 2; i++) {
+            nibble = (0 == i) ? ((uint8_t)(displayCode >> 4) & 0x0F) : ((uint8_t)displayCode & 0x0F);
+
+            displayI2cPort = LCD_I2C_BIT_BL | rs | (uint8_t)(nibble << LCD_I2C_DATA_SHIFT);
+            displayI2cBuffer[bytes++] = displayI2cPort | LCD_I2C_BIT_EN;
+            displayI2cBuffer[bytes++] = displayI2cPort;
+
+            // Arranque en 8 bits: un solo pulso, el nibble bajo es la espera
+            if (displayCode & DISPLAY_CODE_NIBBLE) {
+                break;
+            }
+        }
+        codes++;
+
+        if (0 < displayInitPending) {
+            displayInitPending--;
+        }
+
+        if (displayCode & DISPLAY_CODE_NIBBLE) {
+            displayI2cWaitMs = (uint8_t)(displayCode & 0x0F);
+            break;
+        }
+        if (!(displayCode & DISPLAY_CODE_RS) && ((uint8_t)displayCode <= 0x03)) {
+            displayI2cWaitMs = MS_EXEC_CLEAR;
+            break;
+        }
+    }
+
+    if (0 == codes) {
+        return false;
+    }
+
+    DISPLAY_I2C_CH->CCR &= ~DMA_CCR_EN;
+    DISPLAY_I2C_CH->CNDTR = bytes;
+    DISPLAY_I2C_CH->CCR |= DMA_CCR_EN;
+
+    displayI2cTick = HAL_GetTick();
+    displayI2cBusy = true;
+    DISPLAY_I2C->CR2 |= I2C_CR2_ITEVTEN | I2C_CR2_ITERREN | I2C_CR2_DMAEN;
+    DISPLAY_I2C->CR1 |= I2C_CR1_START;
+
+    displayI2cStats.bursts++;
+    displayI2cStats.codes += codes;
+    displayI2cStats.bytes += bytes;
+    displayI2cStats.cycles += cycle_counter_get() - start;
+
+    return true;
+}
+
+/**
+ * @brief  STOP y fin de la ráfaga (ISR de I2C2 o timeout con interrupciones apagadas)
+ */
+static void displayI2cStop(void)
+{
+    DISPLAY_I2C->CR1 |= I2C_CR1_STOP;
+    DISPLAY_I2C->CR2 &= ~(I2C_CR2_ITEVTEN | I2C_CR2_ITERREN | I2C_CR2_DMAEN);
+    DISPLAY_I2C_CH->CCR &= ~DMA_CCR_EN;
+    DMA1->IFCR = DISPLAY_I2C_IFCR;
+    displayI2cBusy = false;
+}
+
+/**
+ * @brief  displayUpdate() del backend I2C: espera el fin de la ráfaga (lo marca
+ * la ISR), corre la espera del último código y arma la siguiente. Si una ráfaga
+ * se perdió se reinicia el bus y el próximo diff reenvía la pantalla entera;
+ * si el arranque no había terminado, antes se repite la secuencia completa.
+ */
+static void displayI2cUpdate(void)
+{
+    if (DISPLAY_ENGINE_I2C == displayEngineState) {
+        if (displayI2cBusy) {
+            if ((HAL_GetTick() - displayI2cTick) < MS_I2C_TIMEOUT) {
+                return;
+            }
+
+            __asm("CPSID i");   /* disable interrupts*/
+            if (displayI2cBusy) {
+                displayI2cStats.errors++;
+                displayI2cFailed = true;
+                displayI2cStop();
+            }
+            __asm("CPSIE i");   /* enable interrupts*/
+        }
+
+        // Ráfaga aceptada con la secuencia de arranque ya enviada
+        if (!displayI2cFailed && (0 == displayInitPending)) {
+            displayI2cInitDone = true;
+        }
+
+        displayWait(displayI2cWaitMs * 1000);
+        displayEngineState = DISPLAY_ENGINE_IDLE;
+    }
+
+    if (displayI2cFailed) {
+        displayI2cFailed = false;
+        displayI2cReset();
+        displayWait(MS_I2C_RETRY * 1000);
+
+        // Los códigos de arranque de la ráfaga perdida ya salieron de la cola:
+        // sin ellos el HD44780 queda sin configurar, se repite todo
+        if (!displayI2cInitDone) {
+            ring_buffer_init(&displayQueue, displayQueueBuffer, DISPLAY_QUEUE_SIZE, sizeof(uint16_t));
+            displayInitQueue();
+        }
+
+        // Puerto del expansor desconocido: RS = 1 fuerza a escribir RS antes
+        // del primer pulso (lo primero es el arranque o una dirección)
+        displayI2cPort = LCD_I2C_BIT_BL | LCD_I2C_BIT_RS;
+
+        memset(displayShadow, 0, sizeof(displayShadow));
+        displayAddr = DISPLAY_ADDR_NONE;
+        displayDirty = true;
+    }
+
+    if (displayDirty && ring_buffer_is_empty(&displayQueue)) {
+        displayFrameDiff();
+    }
+
+    if (displayWaitDone() && displayI2cStart()) {
+        displayEngineState = DISPLAY_ENGINE_I2C;
+    }
+}
+#endif
+
+#if (1 == DISPLAY_CFG_BUSY_FLAG)
+/**
+ * @brief  Suma un pin de datos a las máscaras de CRL/CRH de su puerto
+ */
+static void displayBusCrAdd(GPIO_TypeDef *port, uint16_t pin)
+{
+    uint32_t index = 31u - __CLZ(pin);      // Número de pin
+    uint32_t shift = (index & 0x07u) * 4u;
+    displayBusCr_t *pCr = &displayBusCr[(LCD_D4_PORT == port) ? 0 : 1][index >> 3];
+
+    pCr->mask |= 0x0Fu << shift;
+    pCr->input |= 0x04u << shift;
+    pCr->output |= 0x03u << shift;
+}
+
+/**
+ * @brief  Pines de datos del bus como entrada (lectura de BF) o salida
+ * push-pull: un store a CRL/CRH por registro con pines, sin HAL_GPIO_Init()
+ */
+static void displayBusDirection(bool input)
+{
+    static GPIO_TypeDef * const ports[2] = { LCD_D4_PORT, LCD_D7_PORT };
+    const displayBusCr_t *pCr;
+    uint32_t port;
+
+    for (port = 0; port < ((LCD_D4_PORT != LCD_D7_PORT) ? 2u : 1u); port++) {
+        pCr = displayBusCr[port];
+        if (0 != pCr[0].mask) {
+            ports[port]->CRL = (ports[port]->CRL & ~pCr[0].mask) | (input ? pCr[0].input : pCr[0].output);
+        }
+        if (0 != pCr[1].mask) {
+            ports[port]->CRH = (ports[port]->CRH & ~pCr[1].mask) | (input ? pCr[1].input : pCr[1].output);
+        }
+    }
+}
+
+/**
+ * @brief  Lee el busy flag (D7). En modo 4 bits son dos pulsos de EN, el
+ * segundo (AC3..AC0) se descarta pero completa la lectura; en 8 bits, uno solo
+ */
+static bool displayBusyRead(void)
+{
+    bool busy;
+
+    // D4..D7 (y D0..D3 en 8 bits, AC6..AC0) quedan para el HD44780
+    displayBusDirection(true);
+    displayPinWrite(DISPLAY_PIN_RS, DISPLAY_RS_INSTRUCTION);
+    displayPinWrite(DISPLAY_PIN_RW, 1);
+
+    displayPinWrite(DISPLAY_PIN_EN, 1);
+    lcdFastDelay(US_PULSE_WIDTH);           // tDDR < 360 ns
+    busy = (GPIO_PIN_SET == HAL_GPIO_ReadPin(LCD_D7_PORT, LCD_D7_PIN));
     displayPinWrite(DISPLAY_PIN_EN, 0);
-    displayPinWrite(DISPLAY_PIN_D7, (dataBus & 0x80) >> 7);
-    displayPinWrite(DISPLAY_PIN_D6, (dataBus & 0x40) >> 6);
-    displayPinWrite(DISPLAY_PIN_D5, (dataBus & 0x20) >> 5);
-    displayPinWrite(DISPLAY_PIN_D4, (dataBus & 0x10) >> 4);
 
-    // 2. Si estamos en modo 4 bits, enviamos Nibble Alto + Nibble Bajo
-    if (initial8BitCommunicationIsCompleted)
-    {
-        // Pulso Nibble Alto
+    if (DISPLAY_CONNECTION_GPIO_8BITS != displayConnection) {
+        lcdFastDelay(US_INTER_NIBBLE);
         displayPinWrite(DISPLAY_PIN_EN, 1);
         lcdFastDelay(US_PULSE_WIDTH);
         displayPinWrite(DISPLAY_PIN_EN, 0);
-        lcdFastDelay(US_INTER_NIBBLE);
-
-        // Enviar Nibble Bajo (Bits 3-0)
-        displayPinWrite(DISPLAY_PIN_D7, (dataBus & 0x08) >> 3);
-        displayPinWrite(DISPLAY_PIN_D6, (dataBus & 0x04) >> 2);
-        displayPinWrite(DISPLAY_PIN_D5, (dataBus & 0x02) >> 1);
-        displayPinWrite(DISPLAY_PIN_D4, (dataBus & 0x01));
     }
 
-    // 3. Pulso Final (Nibble Bajo o Único Nibble en Init)
-    displayPinWrite(DISPLAY_PIN_EN, 1);
-    lcdFastDelay(US_PULSE_WIDTH);
-    displayPinWrite(DISPLAY_PIN_EN, 0);
+    displayPinWrite(DISPLAY_PIN_RW, 0);
+    displayBusDirection(false);
 
-    // Tiempo de ejecución del comando (Dead time)
-    lcdFastDelay(US_EXEC_STD);
+    return busy;
 }
+#endif
 
-static void displayCodeWrite(bool type, uint8_t dataBus)
+/**
+ * @brief  D0..D3 del bus de 8 bits como entrada (lectura de BF) o salida push-pull
+ */
+static void displayBusLowDirection(uint32_t mode)
 {
-    if (type == DISPLAY_RS_INSTRUCTION)
-        displayPinWrite(DISPLAY_PIN_RS, DISPLAY_RS_INSTRUCTION);
-    else
-        displayPinWrite(DISPLAY_PIN_RS, DISPLAY_RS_DATA);
+    GPIO_InitTypeDef GPIO_InitStruct = {0};
+
+    GPIO_InitStruct.Mode = mode;
+    GPIO_InitStruct.Pull = GPIO_NOPULL;
+    GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_HIGH;
 
-    displayDataBusWrite(dataBus);
+    GPIO_InitStruct.Pin = LCD_D0_PIN;
+    HAL_GPIO_Init(LCD_D0_PORT, &GPIO_InitStruct);
+    GPIO_InitStruct.Pin = LCD_D1_PIN;
+    HAL_GPIO_Init(LCD_D1_PORT, &GPIO_InitStruct);
+    GPIO_InitStruct.Pin = LCD_D2_PIN;
+    HAL_GPIO_Init(LCD_D2_PORT, &GPIO_InitStruct);
+    GPIO_InitStruct.Pin = LCD_D3_PIN;
+    HAL_GPIO_Init(LCD_D3_PORT, &GPIO_InitStruct);
 }
 
 /**
@@ -212,6 +1409,10 @@ static void displayPinWrite(uint8_t pinName, int value)
     GPIO_PinState state = (value == 0) ? GPIO_PIN_RESET : GPIO_PIN_SET;
 
     switch(pinName) {
+        case DISPLAY_PIN_D0: HAL_GPIO_WritePin(LCD_D0_PORT, LCD_D0_PIN, state); break;
+        case DISPLAY_PIN_D1: HAL_GPIO_WritePin(LCD_D1_PORT, LCD_D1_PIN, state); break;
+        case DISPLAY_PIN_D2: HAL_GPIO_WritePin(LCD_D2_PORT, LCD_D2_PIN, state); break;
+        case DISPLAY_PIN_D3: HAL_GPIO_WritePin(LCD_D3_PORT, LCD_D3_PIN, state); break;
         case DISPLAY_PIN_D4: HAL_GPIO_WritePin(LCD_D4_PORT, LCD_D4_PIN, state); break;
         case DISPLAY_PIN_D5: HAL_GPIO_WritePin(LCD_D5_PORT, LCD_D5_PIN, state); break;
         case DISPLAY_PIN_D6: HAL_GPIO_WritePin(LCD_D6_PORT, LCD_D6_PIN, state); break;
@@ -219,6 +1420,9 @@ static void displayPinWrite(uint8_t pinName, int value)
 
         case DISPLAY_PIN_RS: HAL_GPIO_WritePin(LCD_RS_PORT, LCD_RS_PIN, state); break;
         case DISPLAY_PIN_EN: HAL_GPIO_WritePin(LCD_EN_PORT, LCD_EN_PIN, state); break;
+#if (1 == DISPLAY_CFG_BUSY_FLAG)
+        case DISPLAY_PIN_RW: HAL_GPIO_WritePin(LCD_RW_PORT, LCD_RW_PIN, state); break;
+#endif
         default: break;
     }
 }
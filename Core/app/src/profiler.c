@@ -0,0 +1,155 @@
+/*
+ * profiler.c
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+/********************** inclusions *******************************************/
+/* Project includes. */
+#include "main.h"
+
+/* Demo includes. */
+#include "logger.h"
+#include "dwt.h"
+#include "profiler.h"
+
+/********************** macros and definitions *******************************/
+#define PROFILER_CAL_QTY		(16)
+#define PROFILER_MIN_INI		(0xFFFFFFFFul)
+
+/********************** internal data declaration ****************************/
+
+/********************** internal functions declaration ***********************/
+
+/********************** internal data definition *****************************/
+
+/********************** external data declaration ****************************/
+uint32_t g_profiler_overhead;
+
+/********************** internal functions definition ************************/
+static uint32_t profiler_bucket(uint32_t cycles)
+{
+	uint32_t log2;
+
+	if (0 == cycles)
+	{
+		return 0;
+	}
+
+	log2 = 31ul - __CLZ(cycles);
+
+	if (PROFILER_HIST_SHIFT >= log2)
+	{
+		return 0;
+	}
+
+	log2 -= PROFILER_HIST_SHIFT;
+
+	return (PROFILER_HIST_QTY > log2) ? log2 : (PROFILER_HIST_QTY - 1);
+}
+
+/********************** external functions definition ************************/
+void profiler_init(void)
+{
+	uint32_t index;
+	uint32_t start;
+	uint32_t cycles;
+
+	/* Calibrate: the cheapest empty start/stop pair is the overhead to subtract */
+	g_profiler_overhead = PROFILER_MIN_INI;
+
+	for (index = 0; PROFILER_CAL_QTY > index; index++)
+	{
+		start = profiler_start();
+		cycles = cycle_counter_get() - start;
+
+		if (g_profiler_overhead > cycles)
+		{
+			g_profiler_overhead = cycles;
+		}
+	}
+}
+
+void profiler_reset(profiler_dta_t *p_dta)
+{
+	uint32_t index;
+
+	p_dta->cnt = 0;
+	p_dta->min = PROFILER_MIN_INI;
+	p_dta->max = 0;
+	p_dta->last = 0;
+	p_dta->sum = 0;
+
+	for (index = 0; PROFILER_HIST_QTY > index; index++)
+	{
+		p_dta->hist[index] = 0;
+	}
+}
+
+uint32_t profiler_stop(profiler_dta_t *p_dta, uint32_t start)
+{
+	uint32_t cycles;
+
+	/* Unsigned difference: valid across CYCCNT wrap-around */
+	cycles = cycle_counter_get() - start;
+	cycles = (cycles > g_profiler_overhead) ? (cycles - g_profiler_overhead) : 0;
+
+	profiler_add(p_dta, cycles);
+
+	return cycles;
+}
+
+void profiler_add(profiler_dta_t *p_dta, uint32_t cycles)
+{
+	p_dta->cnt++;
+	p_dta->last = cycles;
+	p_dta->sum += cycles;
+
+	if (p_dta->min > cycles)
+	{
+		p_dta->min = cycles;
+	}
+	if (p_dta->max < cycles)
+	{
+		p_dta->max = cycles;
+	}
+
+	p_dta->hist[profiler_bucket(cycles)]++;
+}
+
+uint32_t profiler_mean(const profiler_dta_t *p_dta)
+{
+	if (0 == p_dta->cnt)
+	{
+		return 0;
+	}
+
+	return (uint32_t)(p_dta->sum / p_dta->cnt);
+}
+
+void profiler_log(const char *name, const profiler_dta_t *p_dta)
+{
+	uint32_t index;
+
+	LOGGER_LOG(" [%s]: %lu muestras\r\n", name, p_dta->cnt);
+
+	if (0 == p_dta->cnt)
+	{
+		return;
+	}
+
+	LOGGER_LOG("   min/media/max: %lu/%lu/%lu ciclos\r\n", p_dta->min, profiler_mean(p_dta), p_dta->max);
+
+	for (index = 0; PROFILER_HIST_QTY > index; index++)
+	{
+		if (0 < p_dta->hist[index])
+		{
+			LOGGER_LOG("   %s%lu ciclos: \t%lu\r\n",
+					   (0 == index) ? "< " : ">= ",
+					   (0 == index) ? (1ul << (PROFILER_HIST_SHIFT + 1)) : (1ul << (index + PROFILER_HIST_SHIFT)),
+					   p_dta->hist[index]);
+		}
+	}
+}
+
+/********************** end of file ******************************************/
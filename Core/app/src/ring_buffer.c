@@ -0,0 +1,111 @@
+/*
+ * ring_buffer.c
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+/********************** inclusions *******************************************/
+#include <string.h>
+
+/* Project includes. */
+#include "main.h"
+
+/* Demo includes. */
+#include "logger.h"
+#include "ring_buffer.h"
+
+/********************** macros and definitions *******************************/
+
+/********************** internal data declaration ****************************/
+
+/********************** internal functions declaration ***********************/
+
+/********************** internal data definition *****************************/
+
+/********************** external data declaration ****************************/
+
+/********************** external functions definition ************************/
+bool ring_buffer_init(ring_buffer_t *p_rb, void *p_buffer, uint32_t size, uint32_t item_size)
+{
+	if ((NULL == p_buffer) || !RING_BUFFER_IS_POW2(size) || (0 == item_size))
+	{
+		return false;
+	}
+
+	p_rb->p_buffer = (uint8_t *)p_buffer;
+	p_rb->size = size;
+	p_rb->item_size = item_size;
+	p_rb->head = 0;
+	p_rb->tail = 0;
+	p_rb->overflow_cnt = 0;
+	p_rb->high_watermark = 0;
+
+	return true;
+}
+
+bool ring_buffer_put(ring_buffer_t *p_rb, const void *p_item)
+{
+	uint32_t head;
+	uint32_t count;
+
+	head = p_rb->head;
+	count = head - p_rb->tail;
+
+	/* Full: the new item is dropped, the pending ones are never overwritten */
+	if (p_rb->size <= count)
+	{
+		p_rb->overflow_cnt++;
+		return false;
+	}
+
+	memcpy(&p_rb->p_buffer[(head & (p_rb->size - 1)) * p_rb->item_size], p_item, p_rb->item_size);
+
+	/* The item must be in memory before the consumer can see the new head */
+	__DMB();
+	p_rb->head = head + 1;
+
+	if (p_rb->high_watermark < (count + 1))
+	{
+		p_rb->high_watermark = count + 1;
+	}
+
+	return true;
+}
+
+bool ring_buffer_get(ring_buffer_t *p_rb, void *p_item)
+{
+	uint32_t tail;
+
+	tail = p_rb->tail;
+
+	if (p_rb->head == tail)
+	{
+		return false;
+	}
+
+	/* Read the item only after head was seen, release the slot after reading it */
+	__DMB();
+	memcpy(p_item, &p_rb->p_buffer[(tail & (p_rb->size - 1)) * p_rb->item_size], p_rb->item_size);
+	__DMB();
+	p_rb->tail = tail + 1;
+
+	return true;
+}
+
+bool ring_buffer_is_empty(const ring_buffer_t *p_rb)
+{
+	return (p_rb->head == p_rb->tail);
+}
+
+uint32_t ring_buffer_count(const ring_buffer_t *p_rb)
+{
+	return (p_rb->head - p_rb->tail);
+}
+
+void ring_buffer_log(const char *name, const ring_buffer_t *p_rb)
+{
+	LOGGER_LOG(" [%s]: %lu/%lu pend, max %lu, desbordes %lu\r\n", name,
+			   ring_buffer_count(p_rb), p_rb->size, p_rb->high_watermark, p_rb->overflow_cnt);
+}
+
+/********************** end of file ******************************************/
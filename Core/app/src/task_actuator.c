@@ -43,16 +43,18 @@
 /* Demo includes. */
 #include "logger.h"
 #include "dwt.h"
+#include "profiler.h"
 
 /* Application & Tasks includes. */
 #include "board.h"
 #include "app.h"
+#include "task_system_attribute.h"
 #include "task_actuator_attribute.h"
 #include "task_actuator_interface.h"
+#include "task_actuator.h"
 
 /********************** macros and definitions *******************************/
 #define G_TASK_ACT_CNT_INIT			0ul
-#define G_TASK_ACT_TICK_CNT_INI		0ul
 
 #define DEL_LED_PUL				250ul
 #define DEL_LED_BLI				500ul
@@ -68,7 +70,8 @@ const task_actuator_cfg_t task_actuator_cfg_list[] = {
 		        LED_MOTOR_MAX_ON,
 		        LED_MOTOR_MAX_OFF,
 				DEL_LED_MIN,                      // No usa Blink
-				DEL_LED_MIN	                       // No usa Pulse
+				DEL_LED_MIN,	                   // No usa Pulse
+				true                               // Parada rápida
 		    },
 
 		    // 2. MOTOR VELOCIDAD MÍNIMA (LED 2 - PC7)
@@ -79,7 +82,8 @@ const task_actuator_cfg_t task_actuator_cfg_list[] = {
 		        LED_MOTOR_MIN_ON,
 		        LED_MOTOR_MIN_OFF,
 				DEL_LED_MIN,
-				DEL_LED_MIN
+				DEL_LED_MIN,
+				true
 		    },
 
 		    // 3. INDICADOR SISTEMA OK (LED 3 - PB6)
@@ -90,7 +94,8 @@ const task_actuator_cfg_t task_actuator_cfg_list[] = {
 		        LED_SYSTEM_ON,
 		        LED_SYSTEM_OFF,
 				DEL_LED_BLI,
-		        DEL_LED_PUL
+		        DEL_LED_PUL,
+				false
 		    },
 
 		    // 4. ALERTA / BARRERA (LED 4 - PA7) -> PARPADEANTE
@@ -101,7 +106,8 @@ const task_actuator_cfg_t task_actuator_cfg_list[] = {
 		        LED_ALERT_ON,
 		        LED_ALERT_OFF,
 				DEL_LED_BLI,                    // Blink rápido (250ms ON / 250ms OFF)
-				DEL_LED_PUL
+				DEL_LED_PUL,
+				false
 		    },
 
 			// 5. BUZZER
@@ -112,7 +118,8 @@ const task_actuator_cfg_t task_actuator_cfg_list[] = {
 		        BUZZER_ON,
 		        BUZZER_OFF,
 				DEL_LED_BLI,              // 0 = Sonido Continuo (Sin Blink), 250 = ululando
-				DEL_LED_PUL
+				DEL_LED_PUL,
+				false
 		    }
 };
 
@@ -123,14 +130,64 @@ task_actuator_dta_t task_actuator_dta_list[ACTUATOR_CFG_QTY];
 #define ACTUATOR_DTA_QTY	(sizeof(task_actuator_dta_list)/sizeof(task_actuator_dta_t))
 
 /********************** internal functions declaration ***********************/
+static void task_actuator_write(const task_actuator_cfg_t *p_task_actuator_cfg, task_actuator_dta_t *p_task_actuator_dta, GPIO_PinState state);
+static void task_actuator_trace(const task_actuator_dta_t *p_task_actuator_dta);
 
 /********************** internal data definition *****************************/
 const char *p_task_actuator 		= "Task Actuator (Actuator Statechart)";
 const char *p_task_actuator_ 		= "Non-Blocking & Update By Time Code";
 
+/* Latency from the input edge to the output, per task_system_ev_t */
+static profiler_dta_t task_actuator_latency[EV_SYS_QTY];
+static uint32_t task_actuator_latency_edge[EV_SYS_QTY];		// Last edge counted (CYCCNT)
+
+static const char *p_task_actuator_cause[] = {"IDLE", "INGRESA", "EGRESA", "TOGGLE", "ENTER",
+											  "BARRERA INT", "BARRERA REST", "EMERGENCIA",
+											  "PARADA REST", "ACTIVE"};
+
 /********************** external data declaration ****************************/
 uint32_t g_task_actuator_cnt;
-volatile uint32_t g_task_actuator_tick_cnt;
+uint32_t g_task_actuator_last_tick;
+
+/* Parada rápida: mientras está activa los motores no pueden encenderse */
+volatile bool g_task_actuator_safety_latch;
+profiler_dta_t g_task_actuator_safety_profile;
+
+/********************** internal functions definition ************************/
+static void task_actuator_write(const task_actuator_cfg_t *p_task_actuator_cfg, task_actuator_dta_t *p_task_actuator_dta, GPIO_PinState state)
+{
+	/* Sección crítica: el EXTI no puede colarse entre la consulta y la escritura */
+	__asm("CPSID i");
+
+	if (g_task_actuator_safety_latch && p_task_actuator_cfg->safety_stop)
+	{
+		state = p_task_actuator_cfg->off_state;
+	}
+	HAL_GPIO_WritePin(p_task_actuator_cfg->gpio_port, p_task_actuator_cfg->pin, state);
+
+	__asm("CPSIE i");
+
+	app_stamp(&p_task_actuator_dta->out);
+
+	if (p_task_actuator_dta->trace)
+	{
+		p_task_actuator_dta->trace = false;
+		task_actuator_trace(p_task_actuator_dta);
+	}
+}
+
+/* Input edge -> output written: one sample per edge, the first output it moves */
+static void task_actuator_trace(const task_actuator_dta_t *p_task_actuator_dta)
+{
+	task_system_ev_t cause = p_task_actuator_dta->cause;
+
+	if ((EV_SYS_QTY > cause) &&
+		((0 == task_actuator_latency[cause].cnt) || (task_actuator_latency_edge[cause] != p_task_actuator_dta->edge.cyc)))
+	{
+		task_actuator_latency_edge[cause] = p_task_actuator_dta->edge.cyc;
+		profiler_add(&task_actuator_latency[cause], p_task_actuator_dta->out.cyc - p_task_actuator_dta->edge.cyc);
+	}
+}
 
 /********************** external functions definition ************************/
 void task_actuator_init(void *parameters)
@@ -148,6 +205,14 @@ void task_actuator_init(void *parameters)
 
 	g_task_actuator_cnt = G_TASK_ACT_CNT_INIT;
 
+	g_task_actuator_safety_latch = false;
+	profiler_reset(&g_task_actuator_safety_profile);
+
+	for (index = 0; EV_SYS_QTY > index; index++)
+	{
+		profiler_reset(&task_actuator_latency[index]);
+	}
+
 	/* Print out: Task execution counter */
 	LOGGER_LOG("   %s = %lu\r\n", GET_NAME(g_task_actuator_cnt), g_task_actuator_cnt);
 
@@ -162,6 +227,7 @@ void task_actuator_init(void *parameters)
 		p_task_actuator_dta->event = EV_ACTUATOR_OFF;
 		p_task_actuator_dta->flag = false;
 		p_task_actuator_dta->tick = 0;
+		p_task_actuator_dta->trace = false;
 
 		/* Apagamos físicamente el actuador al inicio por seguridad */
 		HAL_GPIO_WritePin(p_task_actuator_cfg->gpio_port, p_task_actuator_cfg->pin, p_task_actuator_cfg->off_state);
@@ -181,7 +247,7 @@ void task_actuator_init(void *parameters)
 
 	}
 
-	g_task_actuator_tick_cnt = G_TASK_ACT_TICK_CNT_INI;
+	g_task_actuator_last_tick = g_app_tick_cnt;
 }
 
 void task_actuator_update(void *parameters)
@@ -189,153 +255,220 @@ void task_actuator_update(void *parameters)
 	uint32_t index;
 	const task_actuator_cfg_t *p_task_actuator_cfg;
 	task_actuator_dta_t *p_task_actuator_dta;
-	bool b_time_update_required = false;
+	uint32_t tick_now;
 
 	/* Update Task Actuator Counter */
 	g_task_actuator_cnt++;
 
-	/* Protect shared resource (g_task_actuator_tick_cnt) */
-	__asm("CPSID i");	/* disable interrupts*/
-    if (G_TASK_ACT_TICK_CNT_INI < g_task_actuator_tick_cnt)
-    {
-    	g_task_actuator_tick_cnt--;
-    	b_time_update_required = true;
-    }
-    __asm("CPSIE i");	/* enable interrupts*/
-
-    while (b_time_update_required)
-    {
-		/* Protect shared resource (g_task_actuator_tick_cnt) */
-		__asm("CPSID i");	/* disable interrupts*/
-		if (G_TASK_ACT_TICK_CNT_INI < g_task_actuator_tick_cnt)
-		{
-			g_task_actuator_tick_cnt--;
-			b_time_update_required = true;
-		}
-		else
-		{
-			b_time_update_required = false;
-		}
-		__asm("CPSIE i");	/* enable interrupts*/
+	/* Read the timebase once (atomic 32-bit read, no lock required) */
+	tick_now = g_app_tick_cnt;
 
-    	for (index = 0; ACTUATOR_DTA_QTY > index; index++)
+	while (g_task_actuator_last_tick != tick_now)
+	{
+		g_task_actuator_last_tick++;
+
+		for (index = 0; ACTUATOR_DTA_QTY > index; index++)
 		{
-    		/* Update Task Actuator Configuration & Data Pointer */
+			/* Update Task Actuator Configuration & Data Pointer */
 			p_task_actuator_cfg = &task_actuator_cfg_list[index];
 			p_task_actuator_dta = &task_actuator_dta_list[index];
 
 			switch (p_task_actuator_dta->state)
-						{
-							// --- ESTADO: APAGADO ---
-							case ST_ACTUATOR_OFF:
-								if (true == p_task_actuator_dta->flag)
-								{
-									p_task_actuator_dta->flag = false; // Consumimos evento
-
-									if (EV_ACTUATOR_ON == p_task_actuator_dta->event) {
-										HAL_GPIO_WritePin(p_task_actuator_cfg->gpio_port, p_task_actuator_cfg->pin, p_task_actuator_cfg->on_state);
-										p_task_actuator_dta->state = ST_ACTUATOR_ON;
-									}
-									else if (EV_ACTUATOR_BLINK == p_task_actuator_dta->event) {
-										// Iniciamos parpadeo: Encendemos y cargamos timer
-										HAL_GPIO_WritePin(p_task_actuator_cfg->gpio_port, p_task_actuator_cfg->pin, p_task_actuator_cfg->on_state);
-										p_task_actuator_dta->tick = p_task_actuator_cfg->tick_blink;
-										p_task_actuator_dta->state = ST_ACTUATOR_BLINK_ON;
-									}
-								}
-								break;
-
-							// --- ESTADO: ENCENDIDO ---
-							case ST_ACTUATOR_ON:
-								if (true == p_task_actuator_dta->flag)
-								{
-									p_task_actuator_dta->flag = false;
-
-									if (EV_ACTUATOR_OFF == p_task_actuator_dta->event) {
-										HAL_GPIO_WritePin(p_task_actuator_cfg->gpio_port, p_task_actuator_cfg->pin, p_task_actuator_cfg->off_state);
-										p_task_actuator_dta->state = ST_ACTUATOR_OFF;
-									}
-									// Si estamos ON y nos piden BLINK, pasamos directo
-									else if (EV_ACTUATOR_BLINK == p_task_actuator_dta->event) {
-										p_task_actuator_dta->tick = p_task_actuator_cfg->tick_blink;
-										p_task_actuator_dta->state = ST_ACTUATOR_BLINK_ON;
-									}
-								}
-								break;
-
-							// --- ESTADO: PARPADEO (Fase ENCENDIDO) ---
-							case ST_ACTUATOR_BLINK_ON:
-								// 1. Chequeo de Eventos (Prioridad)
-							    if (true == p_task_actuator_dta->flag)
-							    {
-							        p_task_actuator_dta->flag = false;
-
-							        // Caso A:  APAGAR
-							        if (EV_ACTUATOR_OFF == p_task_actuator_dta->event) {
-							            HAL_GPIO_WritePin(p_task_actuator_cfg->gpio_port, p_task_actuator_cfg->pin, p_task_actuator_cfg->off_state);
-							            p_task_actuator_dta->state = ST_ACTUATOR_OFF;
-							            break;
-							        }
-							        // Caso B: ENCENDER FIJO (Detener parpadeo y quedar ON)
-							        else if (EV_ACTUATOR_ON == p_task_actuator_dta->event) {
-							            HAL_GPIO_WritePin(p_task_actuator_cfg->gpio_port, p_task_actuator_cfg->pin, p_task_actuator_cfg->on_state);
-							            p_task_actuator_dta->state = ST_ACTUATOR_ON;
-							            break;
-							        }
-							    }
-
-							    // 2. Lógica de Tiempo
-							    if (p_task_actuator_dta->tick > 0) {
-							        p_task_actuator_dta->tick--;
-							    } else {
-							        // Tiempo cumplido -> Apagar y cambiar fase
-							        HAL_GPIO_WritePin(p_task_actuator_cfg->gpio_port, p_task_actuator_cfg->pin, p_task_actuator_cfg->off_state);
-							        p_task_actuator_dta->tick = p_task_actuator_cfg->tick_blink;
-							        p_task_actuator_dta->state = ST_ACTUATOR_BLINK_OFF;
-							    }
-							    break;
-
-							// --- ESTADO: PARPADEO (Fase APAGADO) ---
-							case ST_ACTUATOR_BLINK_OFF:
-							    // 1. Chequeo de Eventos
-							    if (true == p_task_actuator_dta->flag)
-							    {
-							        p_task_actuator_dta->flag = false;
-
-							        // Caso A: APAGAR
-							        if (EV_ACTUATOR_OFF == p_task_actuator_dta->event) {
-							            p_task_actuator_dta->state = ST_ACTUATOR_OFF;
-							            break;
-							        }
-							        // Caso B: ENCENDER FIJO
-							        else if (EV_ACTUATOR_ON == p_task_actuator_dta->event) {
-							            HAL_GPIO_WritePin(p_task_actuator_cfg->gpio_port, p_task_actuator_cfg->pin, p_task_actuator_cfg->on_state);
-							            p_task_actuator_dta->state = ST_ACTUATOR_ON;
-							            break;
-							        }
-							    }
-
-							    // 2. Lógica de Tiempo
-							    if (p_task_actuator_dta->tick > 0) {
-							        p_task_actuator_dta->tick--;
-							    } else {
-							        // Tiempo cumplido -> Encender y cambiar fase
-							        HAL_GPIO_WritePin(p_task_actuator_cfg->gpio_port, p_task_actuator_cfg->pin, p_task_actuator_cfg->on_state);
-							        p_task_actuator_dta->tick = p_task_actuator_cfg->tick_blink;
-							        p_task_actuator_dta->state = ST_ACTUATOR_BLINK_ON;
-							    }
-							    break;
-
-
-							// --- ESTADO: PULSO ---
-							case ST_ACTUATOR_PULSE:
-								break;
-
-							default:
-								break;
+			{
+				// --- ESTADO: APAGADO ---
+				case ST_ACTUATOR_OFF:
+					if (true == p_task_actuator_dta->flag)
+					{
+						p_task_actuator_dta->flag = false; // Consumimos evento
+
+						if (EV_ACTUATOR_ON == p_task_actuator_dta->event) {
+							task_actuator_write(p_task_actuator_cfg, p_task_actuator_dta, p_task_actuator_cfg->on_state);
+							p_task_actuator_dta->state = ST_ACTUATOR_ON;
+						}
+						else if (EV_ACTUATOR_BLINK == p_task_actuator_dta->event) {
+							// Iniciamos parpadeo: Encendemos y cargamos timer
+							task_actuator_write(p_task_actuator_cfg, p_task_actuator_dta, p_task_actuator_cfg->on_state);
+							p_task_actuator_dta->tick = p_task_actuator_cfg->tick_blink;
+							p_task_actuator_dta->state = ST_ACTUATOR_BLINK_ON;
 						}
 					}
-			    }
+					break;
+
+				// --- ESTADO: ENCENDIDO ---
+				case ST_ACTUATOR_ON:
+					if (true == p_task_actuator_dta->flag)
+					{
+						p_task_actuator_dta->flag = false;
+
+						if (EV_ACTUATOR_OFF == p_task_actuator_dta->event) {
+							task_actuator_write(p_task_actuator_cfg, p_task_actuator_dta, p_task_actuator_cfg->off_state);
+							p_task_actuator_dta->state = ST_ACTUATOR_OFF;
+						}
+						// Si estamos ON y nos piden BLINK, pasamos directo
+						else if (EV_ACTUATOR_BLINK == p_task_actuator_dta->event) {
+							p_task_actuator_dta->tick = p_task_actuator_cfg->tick_blink;
+							p_task_actuator_dta->state = ST_ACTUATOR_BLINK_ON;
+						}
+					}
+					break;
+
+				// --- ESTADO: PARPADEO (Fase ENCENDIDO) ---
+				case ST_ACTUATOR_BLINK_ON:
+					// 1. Chequeo de Eventos (Prioridad)
+					if (true == p_task_actuator_dta->flag)
+					{
+						p_task_actuator_dta->flag = false;
+
+						// Caso A:  APAGAR
+						if (EV_ACTUATOR_OFF == p_task_actuator_dta->event) {
+							task_actuator_write(p_task_actuator_cfg, p_task_actuator_dta, p_task_actuator_cfg->off_state);
+							p_task_actuator_dta->state = ST_ACTUATOR_OFF;
+							break;
+						}
+						// Caso B: ENCENDER FIJO (Detener parpadeo y quedar ON)
+						else if (EV_ACTUATOR_ON == p_task_actuator_dta->event) {
+							task_actuator_write(p_task_actuator_cfg, p_task_actuator_dta, p_task_actuator_cfg->on_state);
+							p_task_actuator_dta->state = ST_ACTUATOR_ON;
+							break;
+						}
+					}
+
+					// 2. Lógica de Tiempo
+					if (p_task_actuator_dta->tick > 0) {
+						p_task_actuator_dta->tick--;
+					} else {
+						// Tiempo cumplido -> Apagar y cambiar fase
+						task_actuator_write(p_task_actuator_cfg, p_task_actuator_dta, p_task_actuator_cfg->off_state);
+						p_task_actuator_dta->tick = p_task_actuator_cfg->tick_blink;
+						p_task_actuator_dta->state = ST_ACTUATOR_BLINK_OFF;
+					}
+					break;
+
+				// --- ESTADO: PARPADEO (Fase APAGADO) ---
+				case ST_ACTUATOR_BLINK_OFF:
+					// 1. Chequeo de Eventos
+					if (true == p_task_actuator_dta->flag)
+					{
+						p_task_actuator_dta->flag = false;
+
+						// Caso A: APAGAR
+						if (EV_ACTUATOR_OFF == p_task_actuator_dta->event) {
+							p_task_actuator_dta->state = ST_ACTUATOR_OFF;
+							break;
+						}
+						// Caso B: ENCENDER FIJO
+						else if (EV_ACTUATOR_ON == p_task_actuator_dta->event) {
+							task_actuator_write(p_task_actuator_cfg, p_task_actuator_dta, p_task_actuator_cfg->on_state);
+							p_task_actuator_dta->state = ST_ACTUATOR_ON;
+							break;
+						}
+					}
+
+					// 2. Lógica de Tiempo
+					if (p_task_actuator_dta->tick > 0) {
+						p_task_actuator_dta->tick--;
+					} else {
+						// Tiempo cumplido -> Encender y cambiar fase
+						task_actuator_write(p_task_actuator_cfg, p_task_actuator_dta, p_task_actuator_cfg->on_state);
+						p_task_actuator_dta->tick = p_task_actuator_cfg->tick_blink;
+						p_task_actuator_dta->state = ST_ACTUATOR_BLINK_ON;
+					}
+					break;
+
+
+				// --- ESTADO: PULSO ---
+				case ST_ACTUATOR_PULSE:
+					break;
+
+				default:
+					break;
 			}
 
+			/* Evento consumido sin mover la salida: no hay latencia que medir */
+			if (false == p_task_actuator_dta->flag)
+			{
+				p_task_actuator_dta->trace = false;
+			}
+		}
+	}
+}
+
+void safety_stop_task_actuator(uint32_t start)
+{
+	uint32_t index;
+	const task_actuator_cfg_t *p_task_actuator_cfg;
+
+	g_task_actuator_safety_latch = true;
+
+	for (index = 0; ACTUATOR_CFG_QTY > index; index++)
+	{
+		p_task_actuator_cfg = &task_actuator_cfg_list[index];
+
+		if (p_task_actuator_cfg->safety_stop)
+		{
+			/* BSRR: escritura atómica del pin, sin leer-modificar-escribir ODR */
+			p_task_actuator_cfg->gpio_port->BSRR = (GPIO_PIN_SET == p_task_actuator_cfg->off_state) ?
+					(uint32_t)p_task_actuator_cfg->pin : ((uint32_t)p_task_actuator_cfg->pin << 16u);
+		}
+	}
+
+	profiler_stop(&g_task_actuator_safety_profile, start);
+}
+
+void safety_release_task_actuator(void)
+{
+	uint32_t index;
+	const task_actuator_cfg_t *p_task_actuator_cfg;
+	task_actuator_st_t state;
+
+	if (!g_task_actuator_safety_latch)
+	{
+		return;
+	}
+
+	__asm("CPSID i");
+
+	/* Solo con el switch liberado: un flanco nuevo vuelve a activar el corte */
+	if (SW_DESACTIVAR_ON != HAL_GPIO_ReadPin(SW_DESACTIVAR_PORT, SW_DESACTIVAR_PIN))
+	{
+		g_task_actuator_safety_latch = false;
+
+		/* Restauramos la salida que corresponde al estado de la statechart */
+		for (index = 0; ACTUATOR_CFG_QTY > index; index++)
+		{
+			p_task_actuator_cfg = &task_actuator_cfg_list[index];
+			state = task_actuator_dta_list[index].state;
+
+			if (p_task_actuator_cfg->safety_stop)
+			{
+				HAL_GPIO_WritePin(p_task_actuator_cfg->gpio_port, p_task_actuator_cfg->pin,
+								  ((ST_ACTUATOR_ON == state) || (ST_ACTUATOR_BLINK_ON == state)) ?
+								  p_task_actuator_cfg->on_state : p_task_actuator_cfg->off_state);
+			}
+		}
+	}
+
+	__asm("CPSIE i");
+}
+
+void task_actuator_log_latency(void)
+{
+	uint32_t index;
+	const profiler_dta_t *p_latency;
+
+	LOGGER_LOG(" [LATENCIA]: flanco de entrada -> salida\r\n");
+
+	for (index = 0; EV_SYS_QTY > index; index++)
+	{
+		p_latency = &task_actuator_latency[index];
+
+		if (0 < p_latency->cnt)
+		{
+			LOGGER_LOG("   %s: %lu ev, media/max %lu/%lu us\r\n", p_task_actuator_cause[index],
+					   p_latency->cnt, profiler_mean(p_latency) / cycles_per_us,
+					   p_latency->max / cycles_per_us);
+		}
+	}
+}
+
 /********************** end of file ******************************************/
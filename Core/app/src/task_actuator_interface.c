@@ -47,7 +47,9 @@
 /* Application & Tasks includes. */
 #include "board.h"
 #include "app.h"
+#include "task_system_attribute.h"
 #include "task_actuator_attribute.h"
+#include "task_actuator_interface.h"
 
 /********************** macros and definitions *******************************/
 
@@ -56,6 +58,10 @@
 /********************** internal functions declaration ***********************/
 
 /********************** internal data definition *****************************/
+/* Set by task system for each event it takes, copied into every order it gives */
+static task_system_ev_t task_actuator_cause;
+static app_stamp_t task_actuator_cause_stamp;
+static bool task_actuator_cause_valid;
 
 /********************** external data declaration ****************************/
 
@@ -67,7 +73,21 @@ void put_event_task_actuator(task_actuator_ev_t event, task_actuator_id_t identi
 	p_task_actuator_dta = &task_actuator_dta_list[identifier];
 
 	p_task_actuator_dta->event = event;
+	p_task_actuator_dta->cause = task_actuator_cause;
+	p_task_actuator_dta->edge = task_actuator_cause_stamp;
+	p_task_actuator_dta->trace = task_actuator_cause_valid;
 	p_task_actuator_dta->flag = true;
 }
 
+void cause_event_task_actuator(task_system_ev_t cause, const app_stamp_t *p_stamp)
+{
+	task_actuator_cause = cause;
+	task_actuator_cause_valid = (NULL != p_stamp);
+
+	if (NULL != p_stamp)
+	{
+		task_actuator_cause_stamp = *p_stamp;
+	}
+}
+
 /********************** end of file ******************************************/
@@ -7,31 +7,159 @@
 
 
 #include "main.h"
+#include "app.h"
 #include "task_display_attribute.h"
 #include "task_display_interface.h"
 #include "display.h"
-#include <stdio.h>
+#include "logger.h"
+#include <string.h>
+
+// Backend del LCD: DISPLAY_CONNECTION_GPIO_4BITS (la CPU escribe cada nibble),
+// DISPLAY_CONNECTION_GPIO_4BITS_DMA (TIM2 + DMA1 envían el cuadro en segundo plano),
+// DISPLAY_CONNECTION_GPIO_8BITS (la CPU escribe cada byte, D0..D3 en board.h) o
+// DISPLAY_CONNECTION_I2C (backpack PCF8574)
+#ifndef TASK_DISPLAY_CONNECTION
+#define TASK_DISPLAY_CONNECTION DISPLAY_CONNECTION_GPIO_4BITS_DMA
+#endif
+
+// Frecuencia máxima de cuadros: los cambios del modelo que llegan antes de que
+// pase TASK_DISPLAY_FRAME_MS desde el último cuadro se dibujan todos juntos
+#ifndef TASK_DISPLAY_FRAME_MS
+#define TASK_DISPLAY_FRAME_MS   50ul    // 20 cuadros/s
+#endif
+
+// Duración de la pantalla de bienvenida: es un estado temporizado, el resto
+// del sistema corre mientras tanto
+#ifndef TASK_DISPLAY_SPLASH_MS
+#define TASK_DISPLAY_SPLASH_MS  2000ul
+#endif
 
 // Instancia de los datos
 task_display_dta_t task_display_dta;
 
-// Buffer temporal para formatear texto (17 chars + null)
-// Nota: Aunque el display es de 16x2, la solucion para la problematica
-// de impresion de basura en el display fue aumentar el buffer
-static char line_buffer[18];
+// Glifo de grados en CGRAM 0 (se muestra con el código 0x08, alias de 0x00,
+// para no cortar las cadenas con \0)
+#define TASK_DISPLAY_GLYPH_DEG  0
+#define TASK_DISPLAY_DEG        "\x08"
+
+static const uint8_t task_display_glyph_deg[8] = { 0x06, 0x09, 0x09, 0x06, 0x00, 0x00, 0x00, 0x00 };
+
+// Plantillas de línea precompiladas (16 columnas exactas): el texto fijo se
+// copia tal cual y cada campo se escribe en su columna con ancho fijo, sin
+// printf. Un valor que no entra en su ancho se satura (99, -9).
+#define TASK_DISPLAY_COLS       16
+
+typedef struct {
+    const char *p_text;
+    uint8_t     col[2];         // Columna de cada campo
+} task_display_layout_t;
+
+static const task_display_layout_t task_display_layout_status = {
+    "ST:---- P:00    ", { 3, 10 }                           // Estado (4), personas (2)
+};
+static const task_display_layout_t task_display_layout_temps = {
+    "Ti:00" TASK_DISPLAY_DEG "C Ta:00" TASK_DISPLAY_DEG "C ", { 3, 11 }   // Interna (2), ambiente (2)
+};
+static const task_display_layout_t task_display_layout_timeout_title = {
+    " CFG TIEMPO ESP:", { 0, 0 }                            // Sin campos
+};
+static const task_display_layout_t task_display_layout_timeout = {
+    ">>> 00 Segundos ", { 4, 0 }                            // Segundos (2)
+};
+static const task_display_layout_t task_display_layout_limit_title = {
+    " CFG UMBRAL VEL:", { 0, 0 }                            // Sin campos
+};
+static const task_display_layout_t task_display_layout_limit = {
+    ">>> 00 Personas ", { 4, 0 }                            // Personas (2)
+};
+
+// Línea en armado (16 caracteres + \0)
+static char line_buffer[TASK_DISPLAY_COLS + 1];
+
+// Copia del modelo para el cuadro en armado: se toma en una sección crítica,
+// así un productor del primer plano no deja un cuadro a medio actualizar
+typedef struct {
+    task_display_st_t state;
+    char              system_state_str[sizeof(task_display_dta.system_state_str)];
+    uint32_t          people_count;
+    uint32_t          cfg_timeout;
+    uint32_t          cfg_limit;
+    int32_t           temp_internal;
+    int32_t           temp_ambient;
+} task_display_frame_t;
+
+static task_display_frame_t task_display_frame;
+
+static void task_display_line_begin(const task_display_layout_t *p_layout)
+{
+    memcpy(line_buffer, p_layout->p_text, TASK_DISPLAY_COLS);
+    line_buffer[TASK_DISPLAY_COLS] = '\0';
+}
+
+// Entero sin signo, alineado a derecha con ceros ("%02lu" de ancho fijo)
+static void task_display_field_uint(char *p_field, uint8_t width, uint32_t value)
+{
+    uint32_t max = 1;
+    uint8_t index;
+
+    for (index = 0; index < width; index++) {
+        max *= 10;
+    }
+    if (value >= max) {
+        value = max - 1;
+    }
+
+    for (index = width; index > 0; index--) {
+        p_field[index - 1] = (char)('0' + (value % 10));
+        value /= 10;
+    }
+}
+
+// Entero con signo: los negativos usan la primera columna para el '-'
+static void task_display_field_int(char *p_field, uint8_t width, int32_t value)
+{
+    if (value < 0) {
+        p_field[0] = '-';
+        task_display_field_uint(&p_field[1], width - 1, (uint32_t)(-value));
+    } else {
+        task_display_field_uint(p_field, width, (uint32_t)value);
+    }
+}
+
+// Texto alineado a izquierda, recortado o completado con espacios
+static void task_display_field_str(char *p_field, uint8_t width, const char *p_str)
+{
+    uint8_t index;
+
+    for (index = 0; index < width; index++) {
+        p_field[index] = ('\0' != *p_str) ? *p_str++ : ' ';
+    }
+}
+
+static void task_display_line_write(uint8_t row)
+{
+    displayCharPositionWrite(0, row);
+    displayStringWrite(line_buffer);
+}
 
 void task_display_init(void *parameters)
 {
     // 1. Inicializar Hardware del Display
-    displayInit(DISPLAY_CONNECTION_GPIO_4BITS);
+    displayInit(TASK_DISPLAY_CONNECTION);
+    displayGlyphDefine(TASK_DISPLAY_GLYPH_DEG, task_display_glyph_deg);
 
     // 2. Inicializar Datos
     task_display_dta.state = ST_DSP_INIT;
     task_display_dta.event = EV_DSP_REFRESH_REQ;
     task_display_dta.flag = true;
+    task_display_dta.splash_drawn = false;
+    memset(&task_display_dta.stats, 0, sizeof(task_display_dta.stats));
+    task_display_dta.frame_tick = HAL_GetTick() - TASK_DISPLAY_FRAME_MS;
+    task_display_dta.frame_held = false;
+    task_display_dta.stats.window_tick = HAL_GetTick();
 
     // Valores por defecto seguros
-    sprintf(task_display_dta.system_state_str, "INIT");
+    strcpy(task_display_dta.system_state_str, "INIT");
     task_display_dta.people_count = 0;
     task_display_dta.temp_internal = 0;
     task_display_dta.temp_ambient = 0;
@@ -39,12 +167,63 @@ void task_display_init(void *parameters)
 
 void task_display_update(void *parameters)
 {
-    // Solo actualizamos si hay una petición de refresco
+    // Motor asíncrono del LCD: como mucho un byte por llamada, sin esperas largas
+    displayUpdate();
+
+    // Bienvenida: se dibuja una vez y queda en pantalla TASK_DISPLAY_SPLASH_MS
+    // (un Display_SetState() de otra tarea la corta antes)
+    if ((ST_DSP_INIT == task_display_dta.state) && task_display_dta.splash_drawn)
+    {
+        // Arranque: LCD inicializado y bienvenida enviada
+        if (displayFrameDone()) {
+            app_boot_mark(APP_BOOT_DISPLAY);
+        }
+
+        if ((HAL_GetTick() - task_display_dta.splash_tick) < TASK_DISPLAY_SPLASH_MS) {
+            return;
+        }
+
+        // Los pedidos que llegaron durante la bienvenida van en este cuadro.
+        // Se vuelve a mirar el estado con las interrupciones cortadas: si el
+        // primer plano pidió otra pantalla (ej. ST_DSP_ALERT) se respeta
+        __asm("CPSID i");
+        if (ST_DSP_INIT == task_display_dta.state) {
+            task_display_dta.state = ST_DSP_MAIN_STATUS;
+        }
+        task_display_dta.flag = true;
+        __asm("CPSIE i");
+    }
+
+    // Solo actualizamos si hay una petición de refresco (el framebuffer decide qué se envía)
     if (task_display_dta.flag == true)
     {
-    	HAL_Delay(10);
+        // Límite de cuadros: el pedido queda pendiente y junta los que lleguen
+        // (se cuenta una vez por cuadro, no por pasada)
+        if ((HAL_GetTick() - task_display_dta.frame_tick) < TASK_DISPLAY_FRAME_MS) {
+            if (!task_display_dta.frame_held) {
+                task_display_dta.frame_held = true;
+                task_display_dta.stats.deferred++;
+            }
+            return;
+        }
+
+        __asm("CPSID i");
         task_display_dta.flag = false;
-        switch (task_display_dta.state)
+        task_display_frame.state = task_display_dta.state;
+        memcpy(task_display_frame.system_state_str, task_display_dta.system_state_str,
+               sizeof(task_display_frame.system_state_str));
+        task_display_frame.people_count = task_display_dta.people_count;
+        task_display_frame.cfg_timeout = task_display_dta.cfg_timeout;
+        task_display_frame.cfg_limit = task_display_dta.cfg_limit;
+        task_display_frame.temp_internal = task_display_dta.temp_internal;
+        task_display_frame.temp_ambient = task_display_dta.temp_ambient;
+        __asm("CPSIE i");
+
+        task_display_dta.frame_tick = HAL_GetTick();
+        task_display_dta.frame_held = false;
+        task_display_dta.stats.frames++;
+        task_display_dta.stats.window_frames++;
+        switch (task_display_frame.state)
         {
             // --- PANTALLA DE INICIO ---
             case ST_DSP_INIT:
@@ -52,54 +231,57 @@ void task_display_update(void *parameters)
                 displayStringWrite("TdSE Grupo 09");
                 displayCharPositionWrite(0, 1);
                 displayStringWrite("Iniciando...");
-                HAL_Delay(2000);
-                task_display_dta.state = ST_DSP_MAIN_STATUS;
-                task_display_dta.flag = true;
+                task_display_dta.splash_drawn = true;
+                task_display_dta.splash_tick = HAL_GetTick();
                 break;
 
             // --- VISTA PRINCIPAL (Estado + Personas + Temps) ---
-            // Fila 0: "ST:IDLE   P:00"
-            // Fila 1: "Ti:35C   Ta:24C"
+            // Fila 0: "ST:IDLE P:00    "
+            // Fila 1: "Ti:35°C Ta:24°C "
             // ----------------------------------------------------
 
             case ST_DSP_MAIN_STATUS:
-            	// Fila 0 (Estado y personas)
-            	snprintf(line_buffer, sizeof(line_buffer), "ST:%-4s P:%02lu    ",
-            	         task_display_dta.system_state_str,
-            	         task_display_dta.people_count);
-            	displayCharPositionWrite(0, 0);
-            	displayStringWrite(line_buffer);
+            {
+                const task_display_layout_t *p_layout;
+
+                // Fila 0 (Estado y personas)
+                p_layout = &task_display_layout_status;
+                task_display_line_begin(p_layout);
+                task_display_field_str(&line_buffer[p_layout->col[0]], 4, task_display_frame.system_state_str);
+                task_display_field_uint(&line_buffer[p_layout->col[1]], 2, task_display_frame.people_count);
+                task_display_line_write(0);
 
                 // Fila 1 (Temperaturas)
-            	snprintf(line_buffer, sizeof(line_buffer), "Ti:%02ldC  Ta:%02ldC  ",
-            	         task_display_dta.temp_internal,
-            	         task_display_dta.temp_ambient);
-            	displayCharPositionWrite(0, 1);
-            	displayStringWrite(line_buffer);
+                p_layout = &task_display_layout_temps;
+                task_display_line_begin(p_layout);
+                task_display_field_int(&line_buffer[p_layout->col[0]], 2, task_display_frame.temp_internal);
+                task_display_field_int(&line_buffer[p_layout->col[1]], 2, task_display_frame.temp_ambient);
+                task_display_line_write(1);
                 break;
+            }
 
             // --- MENÚ SETUP: TIEMPO ---
-            // Fila 0: "CFG TIEMPO ESP:"
-            // Fila 1: ">> 30 Segundos"
+            // Fila 0: " CFG TIEMPO ESP:"
+            // Fila 1: ">>> 30 Segundos "
             case ST_DSP_SETUP_TIMEOUT:
-                displayCharPositionWrite(0, 0);
-                displayStringWrite(" CFG TIEMPO ESP: ");
+                task_display_line_begin(&task_display_layout_timeout_title);
+                task_display_line_write(0);
 
-                snprintf(line_buffer, 18, ">>> %02lu Segundos  ", task_display_dta.cfg_timeout / 1000);
-                displayCharPositionWrite(0, 1);
-                displayStringWrite(line_buffer);
+                task_display_line_begin(&task_display_layout_timeout);
+                task_display_field_uint(&line_buffer[task_display_layout_timeout.col[0]], 2, task_display_frame.cfg_timeout / 1000);
+                task_display_line_write(1);
                 break;
 
             // --- MENÚ SETUP: LÍMITE PERSONAS ---
-            // Fila 0: "CFG UMBRAL VEL:"
-            // Fila 1: ">> 02 Personas"
+            // Fila 0: " CFG UMBRAL VEL:"
+            // Fila 1: ">>> 02 Personas "
             case ST_DSP_SETUP_THRESHOLD:
-                displayCharPositionWrite(0, 0);
-                displayStringWrite(" CFG UMBRAL VEL: ");
+                task_display_line_begin(&task_display_layout_limit_title);
+                task_display_line_write(0);
 
-                snprintf(line_buffer, 18, ">>> %02lu Personas  ", task_display_dta.cfg_limit);
-                displayCharPositionWrite(0, 1);
-                displayStringWrite(line_buffer);
+                task_display_line_begin(&task_display_layout_limit);
+                task_display_field_uint(&line_buffer[task_display_layout_limit.col[0]], 2, task_display_frame.cfg_limit);
+                task_display_line_write(1);
                 break;
 
             // --- ALERTA / EMERGENCIA ---
@@ -115,3 +297,18 @@ void task_display_update(void *parameters)
         }
     }
 }
+
+void task_display_log_stats(void)
+{
+    task_display_stats_t *p_stats = &task_display_dta.stats;
+    uint32_t window_ms = HAL_GetTick() - p_stats->window_tick;
+
+    LOGGER_LOG(" [DISPLAY]: %lu cuadros, %lu.%lu cuadros/s\r\n", p_stats->frames,
+               (0 < window_ms) ? ((p_stats->window_frames * 1000ul) / window_ms) : 0ul,
+               (0 < window_ms) ? (((p_stats->window_frames * 10000ul) / window_ms) % 10ul) : 0ul);
+    LOGGER_LOG("   pedidos %lu, fusionados %lu, frenados %lu\r\n",
+               p_stats->requests, p_stats->merged, p_stats->deferred);
+
+    p_stats->window_frames = 0;
+    p_stats->window_tick = HAL_GetTick();
+}
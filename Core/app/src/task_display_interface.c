@@ -11,49 +11,79 @@
 #include "task_display_attribute.h"
 #include "task_display_interface.h"
 #include <string.h>
-#include <stdio.h>
+
+/********************** internal functions definition ************************/
+
+// Los productores solo tocan el modelo: todo lo que cambie hasta el próximo
+// cuadro se dibuja junto (task_display_update() limita la frecuencia).
+// task_system escribe desde el primer plano (PendSV) y task_temperature desde
+// el fondo, igual que el render: cada actualización del modelo y su pedido van
+// en una sección crítica. Se llama con las interrupciones deshabilitadas.
+static void display_refresh_request(void)
+{
+    task_display_dta.stats.requests++;
+    if (task_display_dta.flag) {
+        task_display_dta.stats.merged++;
+    }
+
+    task_display_dta.event = EV_DSP_REFRESH_REQ;
+    task_display_dta.flag = true;
+}
 
 /********************** external functions definition ************************/
 
 void Display_SetState(task_display_st_t new_state)
 {
+    __asm("CPSID i");
+
     // Cambiamos el estado
     task_display_dta.state = new_state;
 
     // Generamos un evento de refresco
-    task_display_dta.event = EV_DSP_REFRESH_REQ;
-    task_display_dta.flag = true;
+    display_refresh_request();
+
+    __asm("CPSIE i");
 }
 
 void Display_UpdateData(char *state_str, uint32_t people)
 {
+    __asm("CPSID i");
+
     // Actualizamos el texto de estado (ej: "RUN", "IDLE")
-    snprintf(task_display_dta.system_state_str, sizeof(task_display_dta.system_state_str), "%s", state_str);
+    strncpy(task_display_dta.system_state_str, state_str, sizeof(task_display_dta.system_state_str) - 1);
+    task_display_dta.system_state_str[sizeof(task_display_dta.system_state_str) - 1] = '\0';
 
     // Actualizamos el contador de personas
     task_display_dta.people_count = people;
 
     // Solicitamos pintar la pantalla
-    task_display_dta.event = EV_DSP_REFRESH_REQ;
-    task_display_dta.flag = true;
+    display_refresh_request();
+
+    __asm("CPSIE i");
 }
 
 void Display_UpdateConfig(uint32_t timeout, uint32_t limit)
 {
+    __asm("CPSID i");
+
     task_display_dta.cfg_timeout = timeout;
     task_display_dta.cfg_limit = limit;
 
-    task_display_dta.event = EV_DSP_REFRESH_REQ;
-    task_display_dta.flag = true;
+    display_refresh_request();
+
+    __asm("CPSIE i");
 }
 
 void Display_UpdateTemps(int32_t internal, int32_t ambient)
 {
+    __asm("CPSID i");
+
     task_display_dta.temp_internal = internal;
     task_display_dta.temp_ambient = ambient;
 
-    task_display_dta.event = EV_DSP_REFRESH_REQ;
-    task_display_dta.flag = true;
+    display_refresh_request();
+
+    __asm("CPSIE i");
 }
 
 /********************** end of file ******************************************/
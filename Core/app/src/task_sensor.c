@@ -50,16 +50,41 @@
 #include "task_sensor_attribute.h"
 #include "task_system_attribute.h"
 #include "task_system_interface.h"
+#include "task_actuator_attribute.h"
+#include "task_actuator_interface.h"
 
 /********************** macros and definitions *******************************/
 #define G_TASK_SEN_CNT_INIT			0ul
-#define G_TASK_SEN_TICK_CNT_INI		0ul
 
 #define DEL_BTN_MIN				0ul
 #define DEL_BTN_MED				25ul
 #define DEL_BTN_MAX				50ul
 
+/* Piso del anti-rebote adaptativo */
+#define DEL_BTN_FLOOR			10ul
+#define DEL_SW_FLOOR			20ul
+
+/* Adaptive windows start narrowing after this many bursts (events + glitches) */
+#define SENSOR_ADAPT_BURSTS		4ul
+
+/* Muestreo de las entradas:
+ * 1 = las líneas EXTI (ambos flancos) arman el anti-rebote de su entrada; sin
+ *     flancos ni rebotes en curso task_sensor_update() no lee ni cuenta nada
+ * 0 = todas las entradas se muestrean en cada tick */
+#ifndef TASK_SENSOR_CFG_EXTI
+#define TASK_SENSOR_CFG_EXTI	(1)
+#endif
+
+/* Líneas nuevas: sobre PendSV (foreground), bajo SysTick y la parada rápida */
+#define TASK_SENSOR_EXTI_IRQ_PRIORITY	(14ul)
+#define TASK_SENSOR_EXTI_LINE_QTY		(16ul)
+
 /********************** internal data declaration ****************************/
+/* Perfiles de anti-rebote */
+static const task_sensor_deb_t task_sensor_deb_btn = {SENSOR_DEB_ADAPTIVE, DEL_BTN_MAX, DEL_BTN_FLOOR};	// Pulsadores
+static const task_sensor_deb_t task_sensor_deb_sw = {SENSOR_DEB_ADAPTIVE, DEL_BTN_MAX, DEL_SW_FLOOR};	// DIP switches
+static const task_sensor_deb_t task_sensor_deb_menu = {SENSOR_DEB_FIXED, DEL_BTN_MAX, DEL_BTN_MAX};		// Menú: sin apuro
+
 const task_sensor_cfg_t task_sensor_cfg_list[] = {
 		// --- 1. SENSOR INGRESO  ---
 		    {
@@ -67,7 +92,7 @@ const task_sensor_cfg_t task_sensor_cfg_list[] = {
 		        BTN_INGRESO_PORT,       // Puerto (desde board.h)
 		        BTN_INGRESO_PIN,        // Pin (desde board.h)
 		        BTN_INGRESO_PRESSED,    // Nivel lógico activo
-		        DEL_BTN_MAX,            // Tiempo de anti-rebote (50ms)
+		        &task_sensor_deb_btn,   // Anti-rebote adaptativo (50 -> 10 ms)
 		        EV_SYS_IDLE,            // Al soltar: No hacemos nada
 		        EV_PERSONA_INGRESA      // Al presionar: Avisamos que entró alguien
 		    },
@@ -78,7 +103,7 @@ const task_sensor_cfg_t task_sensor_cfg_list[] = {
 		        BTN_EGRESO_PORT,
 		        BTN_EGRESO_PIN,
 		        BTN_EGRESO_PRESSED,
-		        DEL_BTN_MAX,
+		        &task_sensor_deb_btn,
 		        EV_SYS_IDLE,
 		        EV_PERSONA_EGRESA       // Avisamos que salió alguien
 		    },
@@ -89,7 +114,7 @@ const task_sensor_cfg_t task_sensor_cfg_list[] = {
 		        BTN_MODE_PORT,
 		        BTN_MODE_PIN,
 		        BTN_MODE_PRESSED,
-		        DEL_BTN_MAX,
+		        &task_sensor_deb_menu,
 		        EV_SYS_IDLE,
 		        EV_SISTEMA_TOGGLE       // Alternar entre Activo/Inactivo
 		    },
@@ -100,7 +125,7 @@ const task_sensor_cfg_t task_sensor_cfg_list[] = {
 		        BTN_ENTER_PORT,
 		        BTN_ENTER_PIN,
 		        BTN_ENTER_PRESSED,
-		        DEL_BTN_MAX,
+		        &task_sensor_deb_menu,
 		        EV_SYS_IDLE,
 		        EV_MENU_ENTER           // Confirmar acción
 		    },
@@ -112,7 +137,7 @@ const task_sensor_cfg_t task_sensor_cfg_list[] = {
 		        SW_BARRERA_PORT,
 		        SW_BARRERA_PIN,
 		        SW_BARRERA_ON,          // "Presionado" es ON (Barrera activa/cortada)
-		        DEL_BTN_MAX,
+		        &task_sensor_deb_sw,
 		        EV_BARRERA_RESTAURADA,  // Signal UP: Barrera libre (No hay personas en la escalera)
 		        EV_BARRERA_INTERRUMPIDA // Signal DOWN: Barrera cortada (Hay personas en la escalera)
 		    },
@@ -123,7 +148,7 @@ const task_sensor_cfg_t task_sensor_cfg_list[] = {
 		        SW_DESACTIVAR_PORT,
 		        SW_DESACTIVAR_PIN,
 		        SW_DESACTIVAR_ON,       // "Presionado" es ON (Sistema de control Apagado)
-		        DEL_BTN_MAX,
+		        &task_sensor_deb_sw,
 		        EV_PARADA_RESTAURADA,   // Signal UP: Sistema habilitado
 		        EV_PARADA_EMERGENCIA    // Signal DOWN: Parada inmediata
 		    },
@@ -134,7 +159,7 @@ const task_sensor_cfg_t task_sensor_cfg_list[] = {
 				BTN_ACTIVE_PORT,
 				BTN_ACTIVE_PIN,
 				BTN_ACTIVE_PRESSED,
-				DEL_BTN_MAX,
+				&task_sensor_deb_btn,
 		    	EV_SYS_IDLE,      // Signal Up: Sistema en reposo
 				EV_SYS_ACTIVE	  // Signal Down: Resaturacion del sistema
 		    }
@@ -142,27 +167,67 @@ const task_sensor_cfg_t task_sensor_cfg_list[] = {
 
 #define SENSOR_CFG_QTY	(sizeof(task_sensor_cfg_list)/sizeof(task_sensor_cfg_t))
 
-task_sensor_dta_t task_sensor_dta_list[SENSOR_CFG_QTY];
+/* Every input is one bit of the debounce masks */
+task_sensor_dta_t task_sensor_dta;
+
+#define SENSOR_PORT_MAX	(4ul)	// GPIOA..GPIOD
 
-#define SENSOR_DTA_QTY	(sizeof(task_sensor_dta_list)/sizeof(task_sensor_dta_t))
+/* Masks derived from task_sensor_cfg_list by task_sensor_init() */
+typedef struct
+{
+	GPIO_TypeDef *	gpio_port[SENSOR_PORT_MAX];		// Ports with inputs, one IDR read each
+	uint32_t		port_qty;
+	uint8_t			port_slot[SENSOR_CFG_QTY];		// Input -> gpio_port[] index
+	uint32_t		invert;							// Active-low inputs (pressed = 0)
+	uint32_t		limit[TASK_SENSOR_CNT_BITS];	// Debounce window, bit plane k
+	uint32_t		emergency;						// Inputs whose signal_down is EV_PARADA_EMERGENCIA
+	uint32_t		poll;							// Inputs sampled every tick (no EXTI line)
+	uint32_t		exti_line[TASK_SENSOR_EXTI_LINE_QTY];	// Input routed to each line (bit mask)
+} task_sensor_map_t;
 
 /********************** internal functions declaration ***********************/
+static uint32_t task_sensor_sample(void);
+static uint32_t task_sensor_debounce(uint32_t raw);
+static void task_sensor_stamp_set(uint32_t index, const app_stamp_t *p_stamp);
+static void task_sensor_burst_end(uint32_t index, bool confirmed);
+static void task_sensor_limit_set(uint32_t index, uint32_t window);
+#if 1 == TASK_SENSOR_CFG_EXTI
+static void task_sensor_exti_init(uint32_t index);
+#endif
 
 /********************** internal data definition *****************************/
-const char *p_task_sensor 		= "Task Sensor (Sensor Statechart)";
+const char *p_task_sensor 		= "Task Sensor (Vertical Counters)";
 const char *p_task_sensor_ 		= "Non-Blocking & Update By Time Code";
 
+static task_sensor_map_t task_sensor_map;
+
+/* Inputs with an edge since the last update: set by the EXTI, taken by the task */
+static volatile uint32_t task_sensor_edge;
+
+/* Capture time of the edge that armed each input (carried by its event), and
+ * of the first and last EXTI edges since the last update */
+static app_stamp_t task_sensor_stamp[SENSOR_CFG_QTY];
+static app_stamp_t task_sensor_exti_stamp[SENSOR_CFG_QTY];
+static app_stamp_t task_sensor_exti_last[SENSOR_CFG_QTY];
+static uint32_t task_sensor_burst;		// Stamped inputs whose event is not out yet
+
+/* Current burst of each input: last change and number of changes */
+static app_stamp_t task_sensor_last[SENSOR_CFG_QTY];
+static uint32_t task_sensor_changes[SENSOR_CFG_QTY];
+static uint32_t task_sensor_edges_seen[SENSOR_CFG_QTY];	// stats.edges already counted
+
+static task_sensor_bounce_t task_sensor_bounce[SENSOR_CFG_QTY];
+
 /********************** external data declaration ****************************/
 uint32_t g_task_sensor_cnt;
-volatile uint32_t g_task_sensor_tick_cnt;
+uint32_t g_task_sensor_last_tick;
 
 /********************** external functions definition ************************/
 void task_sensor_init(void *parameters)
 {
 	uint32_t index;
-	task_sensor_dta_t *p_task_sensor_dta;
-	task_sensor_st_t state;
-	task_sensor_ev_t event;
+	uint32_t slot;
+	const task_sensor_cfg_t *p_task_sensor_cfg;
 
 	/* Print out: Task Initialized */
 	LOGGER_LOG("  %s is running - %s\r\n", GET_NAME(task_sensor_init), p_task_sensor);
@@ -173,144 +238,450 @@ void task_sensor_init(void *parameters)
 	/* Print out: Task execution counter */
 	LOGGER_LOG("   %s = %lu\r\n", GET_NAME(g_task_sensor_cnt), g_task_sensor_cnt);
 
-	for (index = 0; SENSOR_DTA_QTY > index; index++)
+	memset(&task_sensor_map, 0, sizeof(task_sensor_map));
+	memset(&task_sensor_dta, 0, sizeof(task_sensor_dta));	// Asumimos todo suelto al inicio
+	memset(task_sensor_bounce, 0, sizeof(task_sensor_bounce));
+	memset(task_sensor_changes, 0, sizeof(task_sensor_changes));
+	memset(task_sensor_edges_seen, 0, sizeof(task_sensor_edges_seen));
+	task_sensor_burst = 0;
+
+	for (index = 0; (SENSOR_CFG_QTY > index) && (TASK_SENSOR_QTY_MAX > index); index++)
 	{
-		/* Update Task Sensor Data Pointer */
-		p_task_sensor_dta = &task_sensor_dta_list[index];
+		p_task_sensor_cfg = &task_sensor_cfg_list[index];
 
-		/* Reseteamos las variables de estado a valores seguros por defecto */
-		p_task_sensor_dta->tick = DEL_BTN_MIN; // Contador a 0
-        p_task_sensor_dta->state = ST_BTN_UP;     // Asumimos suelto al inicio
-        p_task_sensor_dta->event = EV_BTN_UP;     // Último evento conocido: Suelto
+		/* Ports are read once per tick: each one gets a slot */
+		for (slot = 0; task_sensor_map.port_qty > slot; slot++)
+		{
+			if (p_task_sensor_cfg->gpio_port == task_sensor_map.gpio_port[slot])
+			{
+				break;
+			}
+		}
+		if ((task_sensor_map.port_qty == slot) && (SENSOR_PORT_MAX > slot))
+		{
+			task_sensor_map.gpio_port[task_sensor_map.port_qty++] = p_task_sensor_cfg->gpio_port;
+		}
+		task_sensor_map.port_slot[index] = (uint8_t)slot;
 
-        /* Print out: Index & Task execution FSM */
-		LOGGER_LOG("   %s = %lu", GET_NAME(index), index);
+		if (GPIO_PIN_RESET == p_task_sensor_cfg->pressed)
+		{
+			task_sensor_map.invert |= (1ul << index);
+		}
 
-		state = p_task_sensor_dta->state;
-		LOGGER_LOG("   %s = %lu", GET_NAME(state), (uint32_t)state);
+		if (EV_PARADA_EMERGENCIA == p_task_sensor_cfg->signal_down)
+		{
+			task_sensor_map.emergency |= (1ul << index);
+		}
+
+		/* Adaptive profiles start at the full window too */
+		task_sensor_limit_set(index, p_task_sensor_cfg->p_deb->tick_max);
+
+		/* Everything armed once: inputs already active at boot settle without an edge */
+		task_sensor_dta.armed |= (1ul << index);
+		app_stamp(&task_sensor_stamp[index]);
 
-		event = p_task_sensor_dta->event;
-		LOGGER_LOG("   %s = %lu\r\n", GET_NAME(event), (uint32_t)event);
+#if 1 == TASK_SENSOR_CFG_EXTI
+		task_sensor_exti_init(index);
+#else
+		task_sensor_map.poll |= (1ul << index);
+#endif
+
+		/* Print out: Index, debounce window & EXTI */
+		LOGGER_LOG("   %s = %lu", GET_NAME(index), index);
+		LOGGER_LOG("   window = %lu", task_sensor_bounce[index].window);
+		LOGGER_LOG("   exti = %s\r\n", (task_sensor_map.poll & (1ul << index)) ? "no" : "si");
 	}
-	g_task_sensor_tick_cnt = G_TASK_SEN_TICK_CNT_INI;
+
+	task_sensor_edge = 0;
+
+	g_task_sensor_last_tick = g_app_tick_cnt;
 }
 
 void task_sensor_update(void *parameters)
 {
 	uint32_t index;
-	const task_sensor_cfg_t *p_task_sensor_cfg;
-	task_sensor_dta_t *p_task_sensor_dta;
-	bool b_time_update_required = false;
+	uint32_t tick_now;
+	uint32_t raw;
+	uint32_t changed;
+	uint32_t edge;
+	uint32_t armed;
+	uint32_t moved;
+	app_stamp_t stamp;
 
 	/* Update Task Sensor Counter */
 	g_task_sensor_cnt++;
 
-	/* Protect shared resource (g_task_sensor_tick_cnt) */
-	__asm("CPSID i");	/* disable interrupts*/
-    if (G_TASK_SEN_TICK_CNT_INI < g_task_sensor_tick_cnt)
-    {
-    	g_task_sensor_tick_cnt--;
-    	b_time_update_required = true;
-    }
-    __asm("CPSIE i");	/* enable interrupts*/
-
-    while (b_time_update_required)
-    {
-		/* Protect shared resource (g_task_sensor_tick_cnt) */
-		__asm("CPSID i");	/* disable interrupts*/
-		if (G_TASK_SEN_TICK_CNT_INI < g_task_sensor_tick_cnt)
+	/* Boot time: reset -> first pass over the inputs */
+	app_boot_mark(APP_BOOT_SENSOR);
+
+	/* Read the timebase once (atomic 32-bit read, no lock required) */
+	tick_now = g_app_tick_cnt;
+
+	if (g_task_sensor_last_tick == tick_now)
+	{
+		return;
+	}
+
+	/* Inputs with new edges join the ones still settling */
+	if (0 != task_sensor_edge)
+	{
+		__asm("CPSID i");
+		edge = task_sensor_edge;
+		task_sensor_edge = 0;
+
+		/* Newly armed: their event will be stamped with this first edge */
+		for (index = 0, armed = edge; 0 != armed; index++, armed >>= 1)
 		{
-			g_task_sensor_tick_cnt--;
-			b_time_update_required = true;
+			if (armed & 1ul)
+			{
+				if (0 == (task_sensor_dta.armed & (1ul << index)))
+				{
+					task_sensor_stamp_set(index, &task_sensor_exti_stamp[index]);
+				}
+
+				task_sensor_last[index] = task_sensor_exti_last[index];
+				task_sensor_changes[index] += task_sensor_dta.stats.edges[index] - task_sensor_edges_seen[index];
+				task_sensor_edges_seen[index] = task_sensor_dta.stats.edges[index];
+			}
 		}
-		else
+		__asm("CPSIE i");
+
+		task_sensor_dta.armed |= edge;
+	}
+
+	/* One sample of every input, also for the ticks being caught up */
+	raw = ((0 != task_sensor_dta.armed) || (0 != task_sensor_map.poll)) ? task_sensor_sample() : 0;
+
+	/* Inputs without an EXTI line: a level away from the debounced one is their edge,
+	 * and every change between samples one more change of the burst */
+	armed = (raw ^ task_sensor_dta.state) & task_sensor_map.poll & ~task_sensor_dta.armed;
+	moved = (raw ^ task_sensor_dta.raw) & task_sensor_map.poll;
+	if (0 != (armed | moved))
+	{
+		task_sensor_dta.armed |= armed;
+		app_stamp(&stamp);
+
+		for (index = 0; 0 != (armed | moved); index++, armed >>= 1, moved >>= 1)
+		{
+			if (armed & 1ul)
+			{
+				task_sensor_stamp_set(index, &stamp);
+			}
+			if (moved & 1ul)
+			{
+				task_sensor_last[index] = stamp;
+				task_sensor_changes[index]++;
+			}
+		}
+	}
+	task_sensor_dta.raw = raw;
+
+	if (0 == task_sensor_dta.armed)
+	{
+		task_sensor_dta.stats.ticks_idle += tick_now - g_task_sensor_last_tick;
+		g_task_sensor_last_tick = tick_now;
+		return;
+	}
+
+	while (g_task_sensor_last_tick != tick_now)
+	{
+		g_task_sensor_last_tick++;
+		task_sensor_dta.stats.ticks_busy++;
+
+		changed = task_sensor_debounce(raw);
+
+		/* Switch de corte suelto y estable: liberamos la parada rápida del EXTI
+		 * (rebote descartado o switch restaurado) */
+		if (task_sensor_map.emergency & ~task_sensor_dta.state & ~raw)
 		{
-			b_time_update_required = false;
+			safety_release_task_actuator();
 		}
-		__asm("CPSIE i");	/* enable interrupts*/
 
-    	for (index = 0; SENSOR_DTA_QTY > index; index++)
+		/* Confirmed edges fan out in task_sensor_cfg_list order */
+		for (index = 0; 0 != changed; index++, changed >>= 1)
 		{
-    		/* Update Task Sensor Configuration & Data Pointer */
-			p_task_sensor_cfg = &task_sensor_cfg_list[index];
-			p_task_sensor_dta = &task_sensor_dta_list[index];
-
-			if (p_task_sensor_cfg->pressed == HAL_GPIO_ReadPin(p_task_sensor_cfg->gpio_port, p_task_sensor_cfg->pin))
-						{
-							p_task_sensor_dta->event =	EV_BTN_DOWN;
-						}
-						else
-						{
-							p_task_sensor_dta->event =	EV_BTN_UP;
-						}
-
-
-						switch (p_task_sensor_dta->state)
-						{
-							// --- ESTADO: SUELTO ---
-							case ST_BTN_UP:
-
-								if (EV_BTN_DOWN == p_task_sensor_dta->event)
-								{
-									p_task_sensor_dta->tick  = p_task_sensor_cfg->tick_max;
-									p_task_sensor_dta->state = ST_BTN_FALLING;
-								}
-								break;
-
-							// --- ESTADO: REBOTE AL PRESIONAR ---
-
-							case ST_BTN_FALLING:
-
-								if (EV_BTN_UP == p_task_sensor_dta->event)
-								{
-									p_task_sensor_dta->state = ST_BTN_UP;
-								}
-								else if (p_task_sensor_dta->tick > 0)
-								{
-									p_task_sensor_dta->tick--;
-								}
-								else
-								{
-									put_event_task_system(p_task_sensor_cfg->signal_down);
-									p_task_sensor_dta->state = ST_BTN_DOWN;
-								}
-								break;
-
-							// --- ESTADO: PRESIONADO ---
-							case ST_BTN_DOWN:
-
-								if (EV_BTN_UP == p_task_sensor_dta->event)
-								{
-									p_task_sensor_dta->tick  = p_task_sensor_cfg->tick_max;
-									p_task_sensor_dta->state = ST_BTN_RISING;
-								}
-								break;
-
-							// --- ESTADO: REBOTE AL SOLTAR ---
-							case ST_BTN_RISING:
-
-								if (EV_BTN_DOWN == p_task_sensor_dta->event)
-								{
-									p_task_sensor_dta->state = ST_BTN_DOWN;
-								}
-								else if (p_task_sensor_dta->tick > 0)
-								{
-									p_task_sensor_dta->tick--;
-								}
-								else
-								{
-									put_event_task_system(p_task_sensor_cfg->signal_up);
-									p_task_sensor_dta->state = ST_BTN_UP;
-								}
-								break;
-
-							default:
-								p_task_sensor_dta->state = ST_BTN_UP;
-								break;
-						}
-					}
-			    }
+			if (changed & 1ul)
+			{
+				if (task_sensor_burst & (1ul << index))
+				{
+					task_sensor_burst_end(index, true);
+				}
+				put_event_task_system((task_sensor_dta.state & (1ul << index)) ?
+									  task_sensor_cfg_list[index].signal_down :
+									  task_sensor_cfg_list[index].signal_up,
+									  task_sensor_cfg_list[index].identifier, &task_sensor_stamp[index]);
 			}
+		}
+	}
 
-/********************** end of file ******************************************/
+	/* Settled inputs (raw == state, counter back to 0) wait for their next edge */
+	task_sensor_dta.armed &= raw ^ task_sensor_dta.state;
+}
+
+void task_sensor_exti(uint16_t GPIO_Pin)
+{
+	uint32_t input;
+	uint32_t index;
+
+	input = task_sensor_map.exti_line[31ul - __CLZ((uint32_t)GPIO_Pin)];
+
+	if (0 != input)
+	{
+		index = 31ul - __CLZ(input);
+		task_sensor_dta.stats.edges[index]++;
+
+		/* EXTI0 (parada rápida) puede interrumpir a las otras líneas */
+		__asm("CPSID i");
+		app_stamp(&task_sensor_exti_last[index]);
+		if (0 == (task_sensor_edge & input))
+		{
+			task_sensor_exti_stamp[index] = task_sensor_exti_last[index];
+		}
+		task_sensor_edge |= input;
+		__asm("CPSIE i");
+	}
+}
+
+void task_sensor_log_stats(void)
+{
+	uint32_t index;
+	task_sensor_stats_t *p_stats = &task_sensor_dta.stats;
+	const task_sensor_bounce_t *p_bounce;
+
+	LOGGER_LOG(" [SENSOR]: %lu ticks con anti-rebote, %lu sin\r\n",
+			   p_stats->ticks_busy, p_stats->ticks_idle);
+
+	for (index = 0; (SENSOR_CFG_QTY > index) && (TASK_SENSOR_QTY_MAX > index); index++)
+	{
+		p_bounce = &task_sensor_bounce[index];
 
+		if (task_sensor_map.poll & (1ul << index))
+		{
+			LOGGER_LOG("   entrada %lu: sin EXTI, %lu ev, %lu rechazos\r\n", index,
+					   p_bounce->bursts, p_bounce->glitches);
+		}
+		else
+		{
+			LOGGER_LOG("   entrada %lu: %lu flancos, %lu ev, %lu rechazos\r\n", index,
+					   p_stats->edges[index], p_bounce->bursts, p_bounce->glitches);
+		}
+		LOGGER_LOG("     reb %lu (max %lu), asent max %lu us, vent %lu ms\r\n",
+				   p_bounce->bounces, p_bounce->bounce_max, p_bounce->settle_max_us, p_bounce->window);
+	}
+}
+
+/********************** internal functions definition ************************/
+/* Pressed inputs as a mask: one IDR read per port, then the pins are gathered */
+static uint32_t task_sensor_sample(void)
+{
+	uint32_t idr[SENSOR_PORT_MAX];
+	uint32_t slot;
+	uint32_t index;
+	uint32_t raw = 0;
+
+	for (slot = 0; task_sensor_map.port_qty > slot; slot++)
+	{
+		idr[slot] = task_sensor_map.gpio_port[slot]->IDR;
+	}
+
+	for (index = 0; (SENSOR_CFG_QTY > index) && (TASK_SENSOR_QTY_MAX > index); index++)
+	{
+		if (idr[task_sensor_map.port_slot[index]] & task_sensor_cfg_list[index].pin)
+		{
+			raw |= (1ul << index);
+		}
+	}
+
+	return raw ^ task_sensor_map.invert;
+}
+
+/* A re-arm within the debounce window of a burst that has not raised its event
+ * yet (a bounce seen by a sample) keeps the first edge of the burst */
+static void task_sensor_stamp_set(uint32_t index, const app_stamp_t *p_stamp)
+{
+	if (task_sensor_burst & (1ul << index))
+	{
+		if ((p_stamp->tick - task_sensor_stamp[index].tick) <= (task_sensor_bounce[index].window + 2))
+		{
+			return;
+		}
+
+		/* The previous burst settled back without an event */
+		task_sensor_burst_end(index, false);
+	}
+
+	task_sensor_stamp[index] = *p_stamp;
+	task_sensor_last[index] = *p_stamp;
+	task_sensor_changes[index] = 0;
+	task_sensor_burst |= (1ul << index);
+}
+
+/* Bounce statistics of the burst just ended, and the adaptive window. The
+ * input's counter is 0 here (event just confirmed, or disarmed since the
+ * glitch), so its limit can change */
+static void task_sensor_burst_end(uint32_t index, bool confirmed)
+{
+	const task_sensor_deb_t *p_deb = task_sensor_cfg_list[index].p_deb;
+	task_sensor_bounce_t *p_bounce = &task_sensor_bounce[index];
+	uint32_t settle_us;
+	uint32_t bounces;
+	uint32_t window;
+
+	task_sensor_burst &= ~(1ul << index);
+
+	settle_us = (task_sensor_last[index].cyc - task_sensor_stamp[index].cyc) / cycles_per_us;
+	bounces = (0 < task_sensor_changes[index]) ? (task_sensor_changes[index] - 1) : 0;
+
+	if (confirmed)
+	{
+		p_bounce->bursts++;
+		p_bounce->bounces += bounces;
+		if (bounces > p_bounce->bounce_max)
+		{
+			p_bounce->bounce_max = bounces;
+		}
+	}
+	else
+	{
+		p_bounce->glitches++;
+	}
+
+	if (settle_us > p_bounce->settle_max_us)
+	{
+		p_bounce->settle_max_us = settle_us;
+	}
+
+	/* Peak with a slow decay: one long burst keeps the window wide for a while */
+	p_bounce->settle_peak_us -= p_bounce->settle_peak_us >> 3;
+	if (settle_us > p_bounce->settle_peak_us)
+	{
+		p_bounce->settle_peak_us = settle_us;
+	}
+
+	if ((SENSOR_DEB_ADAPTIVE == p_deb->mode) && (SENSOR_ADAPT_BURSTS <= (p_bounce->bursts + p_bounce->glitches)))
+	{
+		/* Twice the settle time (ms, rounded up) plus one sample: a glitch as
+		 * long as the longest burst seen is still rejected */
+		window = ((2ul * p_bounce->settle_peak_us) + 999ul) / 1000ul + 1ul;
+
+		if (p_deb->tick_min > window)
+		{
+			window = p_deb->tick_min;
+		}
+		if (p_deb->tick_max < window)
+		{
+			window = p_deb->tick_max;
+		}
+
+		task_sensor_limit_set(index, window);
+	}
+}
+
+/* window + 2 equal samples (same instant as the former statechart), as bits
+ * of the limit planes */
+static void task_sensor_limit_set(uint32_t index, uint32_t window)
+{
+	uint32_t limit;
+	uint32_t plane;
+
+	task_sensor_bounce[index].window = window;
+
+	limit = window + 2;
+	if (((1ul << TASK_SENSOR_CNT_BITS) - 1) < limit)
+	{
+		limit = (1ul << TASK_SENSOR_CNT_BITS) - 1;
+	}
+
+	for (plane = 0; TASK_SENSOR_CNT_BITS > plane; plane++)
+	{
+		if (limit & (1ul << plane))
+		{
+			task_sensor_map.limit[plane] |= (1ul << index);
+		}
+		else
+		{
+			task_sensor_map.limit[plane] &= ~(1ul << index);
+		}
+	}
+}
+
+/* One debounce step for every input at once; returns the inputs that changed */
+static uint32_t task_sensor_debounce(uint32_t raw)
+{
+	uint32_t delta;
+	uint32_t carry;
+	uint32_t next;
+	uint32_t equal;
+	uint32_t changed;
+	uint32_t plane;
+
+	task_sensor_dta.raw = raw;
+
+	/* Inputs away from their debounced level count up, the rest restart at 0 */
+	delta = raw ^ task_sensor_dta.state;
+	carry = delta;
+	equal = 0xFFFFFFFFul;
+
+	for (plane = 0; TASK_SENSOR_CNT_BITS > plane; plane++)
+	{
+		next = task_sensor_dta.cnt[plane] & carry;
+		task_sensor_dta.cnt[plane] = (task_sensor_dta.cnt[plane] ^ carry) & delta;
+		carry = next;
+
+		equal &= ~(task_sensor_dta.cnt[plane] ^ task_sensor_map.limit[plane]);
+	}
+
+	/* Counter reached the window: the input takes the new level */
+	changed = delta & equal;
+	task_sensor_dta.state ^= changed;
+
+	for (plane = 0; TASK_SENSOR_CNT_BITS > plane; plane++)
+	{
+		task_sensor_dta.cnt[plane] &= ~changed;
+	}
+
+	return changed;
+}
+
+#if 1 == TASK_SENSOR_CFG_EXTI
+/* Route the input's EXTI line (both edges) unless another port already owns it */
+static void task_sensor_exti_init(uint32_t index)
+{
+	const task_sensor_cfg_t *p_task_sensor_cfg = &task_sensor_cfg_list[index];
+	uint32_t line;
+	uint32_t shift;
+	uint32_t port;
+	IRQn_Type irq;
+
+	line = 31ul - __CLZ((uint32_t)p_task_sensor_cfg->pin);
+	shift = (line & 3ul) * 4ul;
+	port = GPIO_GET_INDEX(p_task_sensor_cfg->gpio_port);
+
+	/* Line in use by another port (MX_GPIO_Init() or an earlier input) */
+	if ((0 != task_sensor_map.exti_line[line]) ||
+		((EXTI->IMR & (1ul << line)) && (port != ((AFIO->EXTICR[line >> 2] >> shift) & 0x0Ful))))
+	{
+		task_sensor_map.poll |= (1ul << index);
+		return;
+	}
+
+	task_sensor_map.exti_line[line] = (1ul << index);
+
+	/* Already enabled by MX_GPIO_Init() (SW_DESACTIVAR): add the rising edge only */
+	if (0 == (EXTI->IMR & (1ul << line)))
+	{
+		AFIO->EXTICR[line >> 2] = (AFIO->EXTICR[line >> 2] & ~(0x0Ful << shift)) | (port << shift);
+		EXTI->PR = (1ul << line);
+
+		irq = (5ul > line) ? (IRQn_Type)(EXTI0_IRQn + line) : ((10ul > line) ? EXTI9_5_IRQn : EXTI15_10_IRQn);
+		HAL_NVIC_SetPriority(irq, TASK_SENSOR_EXTI_IRQ_PRIORITY, 0);
+		HAL_NVIC_EnableIRQ(irq);
+	}
+
+	EXTI->RTSR |= (1ul << line);
+	EXTI->FTSR |= (1ul << line);
+	EXTI->IMR |= (1ul << line);
+}
+#endif
+
+/********************** end of file ******************************************/
@@ -48,6 +48,7 @@
 #include "board.h"
 #include "app.h"
 #include "task_system_attribute.h"
+#include "task_sensor_attribute.h"
 #include "task_system_interface.h"
 #include "task_actuator_attribute.h"
 #include "task_actuator_interface.h"
@@ -56,7 +57,6 @@
 
 /********************** macros and definitions *******************************/
 #define G_TASK_SYS_CNT_INI			0ul
-#define G_TASK_SYS_TICK_CNT_INI		0ul
 
 // Definiciones de tiempo base (ticks de 1ms)
 #define TIMEOUT_MIN   10000UL // 10 Segundos
@@ -77,7 +77,7 @@ const char *p_task_system_ 		= "Non-Blocking & Update By Time Code";
 
 /********************** external data declaration ****************************/
 uint32_t g_task_system_cnt;
-volatile uint32_t g_task_system_tick_cnt;
+uint32_t g_task_system_last_tick;
 
 /********************** external functions definition ************************/
 void task_system_init(void *parameters)
@@ -143,41 +143,37 @@ void task_system_init(void *parameters)
 	    Display_SetState(ST_DSP_INIT);
 	    //Display_UpdateData("IDLE", 0);
 
-	    g_task_system_tick_cnt = G_TASK_SYS_TICK_CNT_INI;
+	    g_task_system_last_tick = g_app_tick_cnt;
 }
 
 void task_system_update(void *parameters)
 {
     task_system_dta_t *p_task_system_dta;
-    bool b_time_update_required = false;
+    task_system_msg_t msg;
+    uint32_t tick_now;
     g_task_system_cnt++;
 
-    __asm("CPSID i");
-    if (G_TASK_SYS_TICK_CNT_INI < g_task_system_tick_cnt) {
-        g_task_system_tick_cnt--;
-        b_time_update_required = true;
-    }
-    __asm("CPSIE i");
+    /* Lectura única de la base de tiempo (lectura atómica de 32 bits, sin bloqueo) */
+    tick_now = g_app_tick_cnt;
 
-    while (b_time_update_required)
+    while (g_task_system_last_tick != tick_now)
     {
-        /* Protección de recurso compartido */
-        __asm("CPSID i");
-        if (G_TASK_SYS_TICK_CNT_INI < g_task_system_tick_cnt) {
-            g_task_system_tick_cnt--;
-            b_time_update_required = true;
-        } else {
-            b_time_update_required = false;
-        }
-        __asm("CPSIE i");
+        g_task_system_last_tick++;
 
         /* Puntero a la estructura de datos en RAM */
         p_task_system_dta = &task_system_dta;
 
         /* 1. VERIFICAR SI HAY EVENTOS NUEVOS EN LA COLA */
         if (true == any_event_task_system()) {
+            get_event_task_system(&msg);
             p_task_system_dta->flag = true;
-            p_task_system_dta->event = get_event_task_system();
+            p_task_system_dta->event = msg.event;
+
+            // Las órdenes a los actuadores de esta pasada heredan el flanco de entrada
+            cause_event_task_actuator(msg.event, &msg.stamp);
+        }
+        else {
+            cause_event_task_actuator(EV_SYS_IDLE, NULL);
         }
 
         // ===============================================================
@@ -43,71 +43,132 @@
 /* Demo includes. */
 #include "logger.h"
 #include "dwt.h"
+#include "profiler.h"
 
 /* Application & Tasks includes. */
 #include "board.h"
 #include "app.h"
+#include "ring_buffer.h"
 #include "task_system_attribute.h"
+#include "task_sensor_attribute.h"
+#include "task_system_interface.h"
 
 /********************** macros and definitions *******************************/
 #define EVENT_UNDEFINED	(255)
-#define MAX_EVENTS		(16)
+#define MAX_EVENTS		(16)	// Power of 2 (ring_buffer)
+#define MAX_EVENTS_SAFETY	(4)		// Power of 2 (ring_buffer)
 
 /********************** internal data declaration ****************************/
+/* Priority lanes: the safety lane is always dequeued first */
+typedef enum queue_lane {QUEUE_LANE_SAFETY,
+						 QUEUE_LANE_NORMAL,
+						 QUEUE_LANE_QTY} queue_lane_t;
+
+typedef struct
+{
+	task_system_msg_t	msg;
+	uint32_t			cyc;		// CYCCNT at put(): queue-wait time
+} queue_item_t;
 
 /********************** internal functions declaration ***********************/
 
 /********************** internal data definition *****************************/
-struct
-{
-	uint32_t	head;
-	uint32_t	tail;
-	uint32_t	count;
-	task_system_ev_t	queue[MAX_EVENTS];
-} queue_task_a;
+/* Producer: task sensor, consumer: task system (lock-free SPSC per lane) */
+static queue_item_t queue_task_a_safety_buffer[MAX_EVENTS_SAFETY];
+static queue_item_t queue_task_a_normal_buffer[MAX_EVENTS];
+static ring_buffer_t queue_task_a[QUEUE_LANE_QTY];
+
+/* Queue-wait time per lane (event class) */
+static profiler_dta_t queue_task_a_wait[QUEUE_LANE_QTY];
+
+static const char *p_queue_lane[] = {"COLA SYS SEG", "COLA SYS NORM"};
 
 /********************** external data declaration ****************************/
 
+/********************** internal functions definition ************************/
+static queue_lane_t queue_lane(task_system_ev_t event)
+{
+	if ((EV_PARADA_EMERGENCIA == event) || (EV_PARADA_RESTAURADA == event))
+	{
+		return QUEUE_LANE_SAFETY;
+	}
+
+	return QUEUE_LANE_NORMAL;
+}
+
 /********************** external functions definition ************************/
 void init_queue_event_task_system(void)
 {
-	uint32_t i;
+	uint32_t lane;
 
-	queue_task_a.head = 0;
-	queue_task_a.tail = 0;
-	queue_task_a.count = 0;
+	ring_buffer_init(&queue_task_a[QUEUE_LANE_SAFETY], queue_task_a_safety_buffer, MAX_EVENTS_SAFETY, sizeof(queue_item_t));
+	ring_buffer_init(&queue_task_a[QUEUE_LANE_NORMAL], queue_task_a_normal_buffer, MAX_EVENTS, sizeof(queue_item_t));
 
-	for (i = 0; i < MAX_EVENTS; i++)
-		queue_task_a.queue[i] = EVENT_UNDEFINED;
+	for (lane = 0; QUEUE_LANE_QTY > lane; lane++)
+	{
+		profiler_reset(&queue_task_a_wait[lane]);
+	}
 }
 
-void put_event_task_system(task_system_ev_t event)
+void put_event_task_system(task_system_ev_t event, task_sensor_id_t identifier, const app_stamp_t *p_stamp)
 {
-	queue_task_a.count++;
-	queue_task_a.queue[queue_task_a.head++] = event;
+	queue_item_t item;
 
-	if (MAX_EVENTS == queue_task_a.head)
-		queue_task_a.head = 0;
-}
+	item.msg.event = event;
+	item.msg.identifier = identifier;
+	item.msg.stamp = *p_stamp;
+	item.cyc = cycle_counter_get();
 
-task_system_ev_t get_event_task_system(void)
+	/* Full lane: the event is dropped and counted (overflow_cnt) */
+	ring_buffer_put(&queue_task_a[queue_lane(event)], &item);
+}
 
+void get_event_task_system(task_system_msg_t *p_msg)
 {
-	task_system_ev_t event;
+	queue_item_t item;
+	uint32_t lane;
+
+	for (lane = 0; QUEUE_LANE_QTY > lane; lane++)
+	{
+		if (true == ring_buffer_get(&queue_task_a[lane], &item))
+		{
+			profiler_add(&queue_task_a_wait[lane], cycle_counter_get() - item.cyc);
+			*p_msg = item.msg;
+			return;
+		}
+	}
+
+	p_msg->event = (task_system_ev_t)EVENT_UNDEFINED;
+}
 
-	queue_task_a.count--;
-	event = queue_task_a.queue[queue_task_a.tail];
-	queue_task_a.queue[queue_task_a.tail++] = EVENT_UNDEFINED;
+bool any_event_task_system(void)
+{
+	uint32_t lane;
 
-	if (MAX_EVENTS == queue_task_a.tail)
-		queue_task_a.tail = 0;
+	for (lane = 0; QUEUE_LANE_QTY > lane; lane++)
+	{
+		if (false == ring_buffer_is_empty(&queue_task_a[lane]))
+		{
+			return true;
+		}
+	}
 
-	return event;
+	return false;
 }
 
-bool any_event_task_system(void)
+void log_queue_event_task_system(void)
 {
-  return (queue_task_a.head != queue_task_a.tail);
+	uint32_t lane;
+	const profiler_dta_t *p_wait;
+
+	for (lane = 0; QUEUE_LANE_QTY > lane; lane++)
+	{
+		p_wait = &queue_task_a_wait[lane];
+
+		ring_buffer_log(p_queue_lane[lane], &queue_task_a[lane]);
+		LOGGER_LOG("   espera media/max: %lu/%lu us (%lu ev)\r\n",
+				   profiler_mean(p_wait) / cycles_per_us, p_wait->max / cycles_per_us, p_wait->cnt);
+	}
 }
 
 /********************** end of file ******************************************/
@@ -7,6 +7,7 @@
 
 
 #include "main.h"
+#include "app.h"
 #include "task_temperature.h"
 #include "task_temperature_attribute.h"
 #include "task_display_interface.h"
@@ -19,7 +20,6 @@
 /********************** macros and definitions *******************************/
 
 #define G_TASK_TEMP_CNT_INI			0ul
-#define G_TASK_TEMP_TICK_CNT_INI	0ul
 
 /********************** external data declaration ****************************/
 
@@ -54,7 +54,7 @@ task_temperature_dta_t task_temp_dta_list[TEMP_SENSOR_QTY];
 /********************** external data definition *****************************/
 
 uint32_t g_task_temp_cnt;
-volatile uint32_t g_task_temp_tick_cnt;
+uint32_t g_task_temp_last_tick;
 
 /********************** external functions definition ************************/
 
@@ -64,7 +64,7 @@ void task_temperature_init(void *parameters)
 		// se procedio a inicialiazarlos en desfase
 		// Inicialización de contadores globales
 	    g_task_temp_cnt = G_TASK_TEMP_CNT_INI;
-	    g_task_temp_tick_cnt = G_TASK_TEMP_TICK_CNT_INI;
+	    g_task_temp_last_tick = g_app_tick_cnt;
 
 	    // Inicialización de sensores
 	    // Sensor 0 (LM35): Arranca al segundo 1
@@ -82,102 +82,93 @@ void task_temperature_init(void *parameters)
 void task_temperature_update(void *parameters)
 {
 
-		bool b_time_update_required = false;
+		uint32_t tick_now;
 
 		/* Update Task Sensor Counter */
 		g_task_temp_cnt++;
 
-		/* Protect shared resource (g_task_sensor_tick_cnt) */
-		__asm("CPSID i");	/* disable interrupts*/
-	    if (G_TASK_TEMP_TICK_CNT_INI < g_task_temp_tick_cnt)
-	    {
-	    	g_task_temp_tick_cnt--;
-	    	b_time_update_required = true;
-	    }
-	    __asm("CPSIE i");	/* enable interrupts*/
+		/* Read the timebase once (atomic 32-bit read, no lock required) */
+		tick_now = g_app_tick_cnt;
 
-	    while (b_time_update_required)
+	    /* Los ticks atrasados solo descuentan la espera entre muestras */
+	    while (g_task_temp_last_tick != tick_now)
 	    {
-			/* Protect shared resource (g_task_sensor_tick_cnt) */
-			__asm("CPSID i");	/* disable interrupts*/
-			if (G_TASK_TEMP_TICK_CNT_INI < g_task_temp_tick_cnt)
-			{
-				g_task_temp_tick_cnt--;
-				b_time_update_required = true;
-			}
-			else
-			{
-				b_time_update_required = false;
-			}
-			__asm("CPSIE i");	/* enable interrupts*/
+	    	g_task_temp_last_tick++;
 
-			// Iteramos por cada sensor
 			for (int i = 0; i < TEMP_SENSOR_QTY; i++)
 			{
-				task_temperature_dta_t *p_dta = &task_temp_dta_list[i];
-				const task_temperature_cfg_t *p_cfg = &task_temp_cfg_list[i];
-
-				switch (p_dta->state)
-				{
-					case ST_ADC_IDLE:
-						if (p_dta->tick > 0) {
-							p_dta->tick--;
-						} else {
-							p_dta->state = ST_ADC_SELECT_CH;
-						}
-						break;
-
-					case ST_ADC_SELECT_CH:
-
-						ADC_ChannelConfTypeDef sConfig = {0};
-						sConfig.Channel = p_cfg->channel;
-						sConfig.Rank = ADC_REGULAR_RANK_1;
-						sConfig.SamplingTime = ADC_SAMPLETIME_239CYCLES_5; // Tiempo estable
-						HAL_ADC_ConfigChannel(p_cfg->hadc, &sConfig);
-
-						p_dta->state = ST_ADC_START;
-						break;
-
-					case ST_ADC_START:
-						HAL_ADC_Start(p_cfg->hadc);
-						p_dta->state = ST_ADC_WAITING;
-						break;
-
-					case ST_ADC_WAITING:
-						if (HAL_ADC_PollForConversion(p_cfg->hadc, 10) == HAL_OK) {
-							p_dta->raw_value = HAL_ADC_GetValue(p_cfg->hadc);
-							HAL_ADC_Stop(p_cfg->hadc);
-							p_dta->state = ST_ADC_READ;
-						}
-						else
-						{
-					        // Recuperación ante falla de lectura
-					        HAL_ADC_Stop(p_cfg->hadc);
-					        p_dta->state = ST_ADC_IDLE; // Volvemos a intentar en el próximo ciclo
-					    }
-						break;
-
-					case ST_ADC_READ:
-
-						// Conversión Matemática
-						if (p_cfg->id == ID_TEMP_INTERNAL) {
-							// Fórmula específica del datasheet STM32F1 para sensor interno
-							// Temp = (V25 - Vsense) / Avg_Slope + 25
-							float vsense = (p_dta->raw_value * 3.3f) / 4095.0f;
-							p_dta->last_temp = (int32_t)((1.43f - vsense) / 0.0043f + 25.0f);
-						} else {
-							// LM35 Lineal
-							p_dta->last_temp = (int32_t)(p_dta->raw_value * p_cfg->multiplier + p_cfg->offset);
-						}
-
-						// Enviar al Display (Solo cuando tenemos ambos listos o individualmente)
-						if (p_cfg->id == ID_TEMP_LM35)
-							Display_UpdateTemps(task_temp_dta_list[1].last_temp, p_dta->last_temp);
-						// Reiniciar ciclo
-						p_dta->tick = 500; // Muestrear cada 500ms
-						p_dta->state = ST_ADC_IDLE;
-						break;
+				if ((ST_ADC_IDLE == task_temp_dta_list[i].state) && (task_temp_dta_list[i].tick > 0)) {
+					task_temp_dta_list[i].tick--;
 				}
 			}
-    }
+	    }
+
+		/* Un estado del ADC por liberación (TASK_TEMP_PERIOD): entre el START y
+		 * el WAITING pasa un período, así la conversión ya terminó y el poll
+		 * no bloquea */
+		for (int i = 0; i < TEMP_SENSOR_QTY; i++)
+		{
+			task_temperature_dta_t *p_dta = &task_temp_dta_list[i];
+			const task_temperature_cfg_t *p_cfg = &task_temp_cfg_list[i];
+
+			switch (p_dta->state)
+			{
+				case ST_ADC_IDLE:
+					if (0 == p_dta->tick) {
+						p_dta->state = ST_ADC_SELECT_CH;
+					}
+					break;
+
+				case ST_ADC_SELECT_CH:
+
+					ADC_ChannelConfTypeDef sConfig = {0};
+					sConfig.Channel = p_cfg->channel;
+					sConfig.Rank = ADC_REGULAR_RANK_1;
+					sConfig.SamplingTime = ADC_SAMPLETIME_239CYCLES_5; // Tiempo estable
+					HAL_ADC_ConfigChannel(p_cfg->hadc, &sConfig);
+
+					p_dta->state = ST_ADC_START;
+					break;
+
+				case ST_ADC_START:
+					HAL_ADC_Start(p_cfg->hadc);
+					p_dta->state = ST_ADC_WAITING;
+					break;
+
+				case ST_ADC_WAITING:
+					if (HAL_ADC_PollForConversion(p_cfg->hadc, 10) == HAL_OK) {
+						p_dta->raw_value = HAL_ADC_GetValue(p_cfg->hadc);
+						HAL_ADC_Stop(p_cfg->hadc);
+						p_dta->state = ST_ADC_READ;
+					}
+					else
+					{
+				        // Recuperación ante falla de lectura
+				        HAL_ADC_Stop(p_cfg->hadc);
+				        p_dta->state = ST_ADC_IDLE; // Volvemos a intentar en el próximo ciclo
+				    }
+					break;
+
+				case ST_ADC_READ:
+
+					// Conversión Matemática
+					if (p_cfg->id == ID_TEMP_INTERNAL) {
+						// Fórmula específica del datasheet STM32F1 para sensor interno
+						// Temp = (V25 - Vsense) / Avg_Slope + 25
+						float vsense = (p_dta->raw_value * 3.3f) / 4095.0f;
+						p_dta->last_temp = (int32_t)((1.43f - vsense) / 0.0043f + 25.0f);
+					} else {
+						// LM35 Lineal
+						p_dta->last_temp = (int32_t)(p_dta->raw_value * p_cfg->multiplier + p_cfg->offset);
+					}
+
+					// Enviar al Display (Solo cuando tenemos ambos listos o individualmente)
+					if (p_cfg->id == ID_TEMP_LM35)
+						Display_UpdateTemps(task_temp_dta_list[1].last_temp, p_dta->last_temp);
+					// Reiniciar ciclo
+					p_dta->tick = 500; // 500 ms + 4 liberaciones del ADC: una muestra cada ~540 ms
+					p_dta->state = ST_ADC_IDLE;
+					break;
+			}
+		}
 }
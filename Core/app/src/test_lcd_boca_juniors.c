@@ -1,17 +1,23 @@
 #include "main.h"
 #include "board.h"
 #include "display.h"
+#include "dwt.h"
 
 /**
  * @brief Función de test de hardware para el LCD.
  * IMPORTANTE: Esta función es bloqueante (usa while(1) y HAL_Delay).
  * Úsala solo para verificar conexiones, no junto con el resto del sistema.
+ * El driver es asíncrono: cada pantalla se envía con displayFlush().
  */
 void test_lcd_boca_juniors(void)
 {
     // 1. Inicializar el Display
+    // Los tiempos del HD44780 se miden con DWT CYCCNT (sin app_init())
+    cycle_counter_init();
+
     // Usa los pines definidos en board.h (GPIOB y GPIOC)
     displayInit(DISPLAY_CONNECTION_GPIO_4BITS);
+    displayFlush();
 
     while (1)
     {
@@ -25,6 +31,7 @@ void test_lcd_boca_juniors(void)
         // Vamos a la Línea 1
         displayCharPositionWrite(0, 1);
         displayStringWrite(" Sistema TdSE 9 ");
+        displayFlush();
 
         // Esperar 5 segundos
         HAL_Delay(5000);
@@ -39,6 +46,7 @@ void test_lcd_boca_juniors(void)
         displayCharPositionWrite(0, 1);
         // El mensaje solicitado
         displayStringWrite("  AGUANTE BOCA  ");
+        displayFlush();
 
         // Esperar 5 segundos
         HAL_Delay(5000);
@@ -0,0 +1,82 @@
+/*
+ * main.h
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+/* Host simulation replacement of Core/Inc/main.h: same pin map, fake HAL */
+
+#ifndef __MAIN_H
+#define __MAIN_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/********************** inclusions *******************************************/
+#include "sim_hal.h"
+
+/********************** external functions declaration ***********************/
+void Error_Handler(void);
+
+/********************** macros ***********************************************/
+/* Pin map, kept in sync with Core/Inc/main.h */
+#define B1_Pin GPIO_PIN_13
+#define B1_GPIO_Port GPIOC
+#define B1_EXTI_IRQn EXTI15_10_IRQn
+#define SW_DESACTIVAR_Pin GPIO_PIN_0
+#define SW_DESACTIVAR_GPIO_Port GPIOC
+#define SW_BARRERA_Pin GPIO_PIN_1
+#define SW_BARRERA_GPIO_Port GPIOC
+#define BTN_INGRESO_Pin GPIO_PIN_0
+#define BTN_INGRESO_GPIO_Port GPIOA
+#define BTN_EGRESO_Pin GPIO_PIN_1
+#define BTN_EGRESO_GPIO_Port GPIOA
+#define USART_TX_Pin GPIO_PIN_2
+#define USART_TX_GPIO_Port GPIOA
+#define USART_RX_Pin GPIO_PIN_3
+#define USART_RX_GPIO_Port GPIOA
+#define BTN_MODE_Pin GPIO_PIN_4
+#define BTN_MODE_GPIO_Port GPIOA
+#define TEMP_LM35_Pin GPIO_PIN_6
+#define TEMP_LM35_GPIO_Port GPIOA
+#define LED_ALERT_Pin GPIO_PIN_7
+#define LED_ALERT_GPIO_Port GPIOA
+#define BTN_ENTER_Pin GPIO_PIN_0
+#define BTN_ENTER_GPIO_Port GPIOB
+#define RS_Pin GPIO_PIN_12
+#define RS_GPIO_Port GPIOB
+#define EN_Pin GPIO_PIN_13
+#define EN_GPIO_Port GPIOB
+#define D4_Pin GPIO_PIN_14
+#define D4_GPIO_Port GPIOB
+#define D5_Pin GPIO_PIN_15
+#define D5_GPIO_Port GPIOB
+#define D6_Pin GPIO_PIN_6
+#define D6_GPIO_Port GPIOC
+#define LED_MOTOR_MIN_Pin GPIO_PIN_7
+#define LED_MOTOR_MIN_GPIO_Port GPIOC
+#define D7_Pin GPIO_PIN_8
+#define D7_GPIO_Port GPIOC
+#define BTN_ACTIVE_Pin GPIO_PIN_8
+#define BTN_ACTIVE_GPIO_Port GPIOA
+#define LED_MOTOR_MAX_Pin GPIO_PIN_9
+#define LED_MOTOR_MAX_GPIO_Port GPIOA
+#define TMS_Pin GPIO_PIN_13
+#define TMS_GPIO_Port GPIOA
+#define TCK_Pin GPIO_PIN_14
+#define TCK_GPIO_Port GPIOA
+#define SWO_Pin GPIO_PIN_3
+#define SWO_GPIO_Port GPIOB
+#define BUZZER_Pin GPIO_PIN_5
+#define BUZZER_GPIO_Port GPIOB
+#define LED_SYSTEM_Pin GPIO_PIN_6
+#define LED_SYSTEM_GPIO_Port GPIOB
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __MAIN_H */
+
+/********************** end of file ******************************************/
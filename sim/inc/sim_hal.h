@@ -0,0 +1,406 @@
+/*
+ * sim_hal.h
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#ifndef SIM_INC_SIM_HAL_H_
+#define SIM_INC_SIM_HAL_H_
+
+/********************** CPP guard ********************************************/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/********************** inclusions *******************************************/
+/* System headers first: the CMSIS look-alike macros below (__asm, snprintf)
+ * must not leak into them */
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <stdlib.h>
+
+/********************** macros ***********************************************/
+#define SIM_CPU_HZ				(64000000ul)	// SystemCoreClock of the target
+#define SIM_TICK_HZ				(1000ul)		// SysTick: 1 mS
+#define SIM_GPIO_PORT_QTY		(4)				// GPIOA..GPIOD
+#define SIM_ADC_CHANNEL_QTY		(18)
+#define SIM_DWT_READ_CYC_INI	(8ul)			// Cost of a CYCCNT poll iteration
+#define SIM_ADC_CONV_CYCLES		(1512ul)		// 252 ADC clocks at 64 MHz / 6
+
+/* CMSIS */
+#define __IO					volatile
+
+#define DWT						(sim_dwt())
+#define CoreDebug				(&sim_core_debug)
+#define DBGMCU					(&sim_dbgmcu)
+#define SCB						(&sim_scb)
+#define RCC						(&sim_rcc)
+#define TIM2					(&sim_tim2)
+#define DMA1					(&sim_dma1)
+#define I2C2					(&sim_i2c2)
+#define EXTI					(&sim_exti)
+#define AFIO					(&sim_afio)
+#define DMA1_Channel2			(sim_dma_channel(2))
+#define DMA1_Channel4			(sim_dma_channel(4))
+#define DMA1_Channel5			(sim_dma_channel(5))
+
+#define DWT_CTRL_CYCCNTENA_Msk			(1ul)
+#define CoreDebug_DEMCR_TRCENA_Msk		(1ul << 24)
+#define DBGMCU_CR_DBG_SLEEP				(1ul)
+#define SCB_ICSR_PENDSVSET_Msk			(1ul << 28)
+
+/* TIM2 + DMA1: only the TIM2 requests (UP -> channel 2, CC1 -> channel 5)
+ * are modelled, memory to peripheral, 32-bit, TIM2 clocked at SIM_CPU_HZ.
+ * Accessing a DMA channel is a simulator step, like a CYCCNT read */
+#define RCC_AHBENR_DMA1EN				(1ul << 0)
+#define RCC_APB1ENR_TIM2EN				(1ul << 0)
+#define TIM_CR1_CEN						(1ul << 0)
+#define TIM_DIER_UDE					(1ul << 8)
+#define TIM_DIER_CC1DE					(1ul << 9)
+#define TIM_EGR_UG						(1ul << 0)
+#define DMA_CCR_EN						(1ul << 0)
+#define DMA_CCR_DIR						(1ul << 4)
+#define DMA_CCR_MINC					(1ul << 7)
+#define DMA_CCR_PSIZE_1					(1ul << 9)
+#define DMA_CCR_MSIZE_1					(1ul << 11)
+#define DMA_CCR_PL_1					(1ul << 13)
+#define DMA_IFCR_CGIF2					(1ul << 4)
+#define DMA_IFCR_CGIF4					(1ul << 12)
+#define DMA_IFCR_CGIF5					(1ul << 16)
+#define SIM_DMA_CHANNEL_QTY				(7)
+
+/* I2C2 master transmitter fed by DMA1 channel 4 (I2C2_TX), standard mode.
+ * SB is cleared by the DR write of the address; ADDR is cleared after the
+ * event handler runs (it reads SR1 + SR2 on the target). The bus clock comes
+ * from CCR and CR2 FREQ, every byte takes 9 SCL periods. */
+#define RCC_APB1ENR_I2C2EN				(1ul << 22)
+#define I2C_CR1_PE						(1ul << 0)
+#define I2C_CR1_START					(1ul << 8)
+#define I2C_CR1_STOP					(1ul << 9)
+#define I2C_CR1_SWRST					(1ul << 15)
+#define I2C_CR2_FREQ					(0x3Ful)
+#define I2C_CR2_ITERREN					(1ul << 8)
+#define I2C_CR2_ITEVTEN					(1ul << 9)
+#define I2C_CR2_DMAEN					(1ul << 11)
+#define I2C_SR1_SB						(1ul << 0)
+#define I2C_SR1_ADDR					(1ul << 1)
+#define I2C_SR1_BTF						(1ul << 2)
+#define I2C_SR1_TXE						(1ul << 7)
+#define I2C_SR1_BERR					(1ul << 8)
+#define I2C_SR1_ARLO					(1ul << 9)
+#define I2C_SR1_AF						(1ul << 10)
+#define I2C_SR1_OVR						(1ul << 11)
+#define I2C_SR2_MSL						(1ul << 0)
+#define I2C_SR2_BUSY					(1ul << 1)
+#define I2C_CCR_CCR						(0xFFFul)
+
+/* "CPSID i" / "CPSIE i" model PRIMASK, WFI sleeps until the next interrupt */
+#define __asm(x)				sim_asm(x)
+#define __WFI()					sim_wfi()
+#define __DMB()					__atomic_thread_fence(__ATOMIC_SEQ_CST)
+
+/* Target longs are 32 bits: "%lu" with uint32_t must print as on the target */
+#define snprintf				sim_snprintf
+#define sprintf					sim_sprintf
+
+/* HAL GPIO */
+#define GPIO_PIN_0				((uint16_t)0x0001)
+#define GPIO_PIN_1				((uint16_t)0x0002)
+#define GPIO_PIN_2				((uint16_t)0x0004)
+#define GPIO_PIN_3				((uint16_t)0x0008)
+#define GPIO_PIN_4				((uint16_t)0x0010)
+#define GPIO_PIN_5				((uint16_t)0x0020)
+#define GPIO_PIN_6				((uint16_t)0x0040)
+#define GPIO_PIN_7				((uint16_t)0x0080)
+#define GPIO_PIN_8				((uint16_t)0x0100)
+#define GPIO_PIN_9				((uint16_t)0x0200)
+#define GPIO_PIN_10				((uint16_t)0x0400)
+#define GPIO_PIN_11				((uint16_t)0x0800)
+#define GPIO_PIN_12				((uint16_t)0x1000)
+#define GPIO_PIN_13				((uint16_t)0x2000)
+#define GPIO_PIN_14				((uint16_t)0x4000)
+#define GPIO_PIN_15				((uint16_t)0x8000)
+
+#define GPIOA					(&sim_gpio[0])
+#define GPIOB					(&sim_gpio[1])
+#define GPIOC					(&sim_gpio[2])
+#define GPIOD					(&sim_gpio[3])
+#define GPIO_GET_INDEX(__GPIOx__)	((uint32_t)((__GPIOx__) - sim_gpio))
+
+/* HAL_GPIO_Init() only writes CNF/MODE in CRL/CRH: every pin is usable in the
+ * sim, the LCD model checks who drives the data bus */
+#define GPIO_MODE_INPUT			(0x00ul)
+#define GPIO_MODE_OUTPUT_PP		(0x01ul)
+#define GPIO_MODE_OUTPUT_OD		(0x11ul)
+#define GPIO_MODE_AF_OD			(0x12ul)
+#define GPIO_NOPULL				(0x00ul)
+#define GPIO_SPEED_FREQ_LOW		(0x02ul)
+#define GPIO_SPEED_FREQ_HIGH	(0x03ul)
+#define GPIO_CR_RESET			(0x44444444ul)	// Every pin floating input
+
+/* HAL ADC */
+#define ADC_CHANNEL_6				(6ul)
+#define ADC_CHANNEL_TEMPSENSOR		(16ul)
+#define ADC_REGULAR_RANK_1			(1ul)
+#define ADC_SAMPLETIME_239CYCLES_5	(7ul)
+
+#define HAL_MAX_DELAY			(0xFFFFFFFFul)
+
+/********************** typedef **********************************************/
+typedef enum
+{
+	HAL_OK = 0,
+	HAL_ERROR,
+	HAL_BUSY,
+	HAL_TIMEOUT
+} HAL_StatusTypeDef;
+
+typedef enum
+{
+	PendSV_IRQn = -2,
+	SysTick_IRQn = -1,
+	EXTI0_IRQn = 6,
+	EXTI1_IRQn = 7,
+	EXTI4_IRQn = 10,
+	EXTI9_5_IRQn = 23,
+	I2C2_EV_IRQn = 33,
+	I2C2_ER_IRQn = 34,
+	EXTI15_10_IRQn = 40
+} IRQn_Type;
+
+typedef enum
+{
+	GPIO_PIN_RESET = 0,
+	GPIO_PIN_SET
+} GPIO_PinState;
+
+typedef struct
+{
+	__IO uint32_t CRL;
+	__IO uint32_t CRH;
+	__IO uint32_t IDR;
+	__IO uint32_t ODR;
+	__IO uint32_t BSRR;		// Applied to ODR on the next simulator step
+	__IO uint32_t BRR;		// Applied to ODR on the next simulator step
+	__IO uint32_t LCKR;
+} GPIO_TypeDef;
+
+/* EXTI: an edge on the line selected by AFIO_EXTICR, unmasked in IMR and
+ * enabled in RTSR/FTSR, calls HAL_GPIO_EXTI_Callback() on the next step.
+ * PR and the NVIC are not modelled */
+typedef struct
+{
+	__IO uint32_t IMR;
+	__IO uint32_t EMR;
+	__IO uint32_t RTSR;
+	__IO uint32_t FTSR;
+	__IO uint32_t SWIER;
+	__IO uint32_t PR;
+} EXTI_TypeDef;
+
+typedef struct
+{
+	__IO uint32_t EVCR;
+	__IO uint32_t MAPR;
+	__IO uint32_t EXTICR[4];
+	uint32_t RESERVED0;
+	__IO uint32_t MAPR2;
+} AFIO_TypeDef;
+
+typedef struct
+{
+	uint32_t Pin;
+	uint32_t Mode;
+	uint32_t Pull;
+	uint32_t Speed;
+} GPIO_InitTypeDef;
+
+typedef struct
+{
+	__IO uint32_t CTRL;
+	__IO uint32_t CYCCNT;
+} DWT_Type;
+
+typedef struct
+{
+	__IO uint32_t DEMCR;
+} CoreDebug_Type;
+
+typedef struct
+{
+	__IO uint32_t ICSR;		// PENDSVSET: PendSV_Handler() runs on the next step
+} SCB_Type;
+
+typedef struct
+{
+	__IO uint32_t IDCODE;
+	__IO uint32_t CR;
+} DBGMCU_TypeDef;
+
+typedef struct
+{
+	__IO uint32_t CR;
+	__IO uint32_t CFGR;
+	__IO uint32_t CIR;
+	__IO uint32_t APB2RSTR;
+	__IO uint32_t APB1RSTR;
+	__IO uint32_t AHBENR;
+	__IO uint32_t APB2ENR;
+	__IO uint32_t APB1ENR;
+} RCC_TypeDef;
+
+typedef struct
+{
+	__IO uint32_t CR1;
+	__IO uint32_t CR2;
+	__IO uint32_t SMCR;
+	__IO uint32_t DIER;
+	__IO uint32_t SR;
+	__IO uint32_t EGR;
+	__IO uint32_t CCMR1;
+	__IO uint32_t CCMR2;
+	__IO uint32_t CCER;
+	__IO uint32_t CNT;
+	__IO uint32_t PSC;
+	__IO uint32_t ARR;
+	__IO uint32_t RCR;
+	__IO uint32_t CCR1;
+} TIM_TypeDef;
+
+typedef struct
+{
+	__IO uint32_t CCR;
+	__IO uint32_t CNDTR;
+	__IO uintptr_t CPAR;	// Host pointers: 32 bits on the target
+	__IO uintptr_t CMAR;
+} DMA_Channel_TypeDef;
+
+typedef struct
+{
+	__IO uint32_t ISR;
+	__IO uint32_t IFCR;
+} DMA_TypeDef;
+
+typedef struct
+{
+	__IO uint32_t CR1;
+	__IO uint32_t CR2;
+	__IO uint32_t OAR1;
+	__IO uint32_t OAR2;
+	__IO uint32_t DR;		// Written by the CPU or DMA1 channel 4, taken by the next step
+	__IO uint32_t SR1;
+	__IO uint32_t SR2;
+	__IO uint32_t CCR;
+	__IO uint32_t TRISE;
+} I2C_TypeDef;
+
+typedef struct
+{
+	void *Instance;
+} ADC_HandleTypeDef;
+
+typedef struct
+{
+	uint32_t Channel;
+	uint32_t Rank;
+	uint32_t SamplingTime;
+} ADC_ChannelConfTypeDef;
+
+/* Called on every simulated tick, before the SysTick interrupt is taken */
+typedef void (*sim_tick_hook_t)(uint32_t ms);
+
+/* Called when an output register (ODR) changes */
+typedef void (*sim_gpio_hook_t)(GPIO_TypeDef *GPIOx, uint32_t odr_old, uint32_t odr_new);
+
+/* Called for every byte on the I2C bus, at its simulated time: the address
+ * phase has byte = SIM_I2C_HOOK_ADDR. Returns the ACK of the slave (false =
+ * nobody there). Also called with SIM_I2C_HOOK_START on every START: false =
+ * SDA held low, the peripheral keeps BUSY until SWRST (PE = 0) */
+#define SIM_I2C_HOOK_ADDR		(-1)
+#define SIM_I2C_HOOK_START		(-2)
+
+typedef bool (*sim_i2c_hook_t)(uint8_t addr, int32_t byte);
+
+typedef struct
+{
+	double		cpu_scale;			// Target cycles per host cycle at 64 MHz
+	uint32_t	dwt_read_cycles;	// Cycles added on every CYCCNT read
+	sim_tick_hook_t tick_hook;
+	sim_gpio_hook_t gpio_hook;
+	sim_i2c_hook_t i2c_hook;
+} sim_cfg_t;
+
+/********************** external data declaration ****************************/
+extern uint32_t SystemCoreClock;
+extern GPIO_TypeDef sim_gpio[SIM_GPIO_PORT_QTY];
+extern CoreDebug_Type sim_core_debug;
+extern DBGMCU_TypeDef sim_dbgmcu;
+extern SCB_Type sim_scb;
+extern RCC_TypeDef sim_rcc;
+extern TIM_TypeDef sim_tim2;
+extern DMA_TypeDef sim_dma1;
+extern DMA_Channel_TypeDef sim_dma1_channel[SIM_DMA_CHANNEL_QTY];
+extern I2C_TypeDef sim_i2c2;
+extern EXTI_TypeDef sim_exti;
+extern AFIO_TypeDef sim_afio;
+
+/********************** external functions declaration ***********************/
+/* CMSIS */
+static inline uint32_t __CLZ(uint32_t value)
+{
+	return (0 == value) ? 32ul : (uint32_t)__builtin_clz(value);
+}
+
+/* HAL */
+HAL_StatusTypeDef HAL_Init(void);
+uint32_t HAL_GetTick(void);
+void HAL_IncTick(void);
+void HAL_Delay(uint32_t Delay);
+void HAL_SYSTICK_Callback(void);
+void HAL_NVIC_SetPriority(IRQn_Type IRQn, uint32_t PreemptPriority, uint32_t SubPriority);
+void HAL_NVIC_EnableIRQ(IRQn_Type IRQn);
+void PendSV_Handler(void);
+void EXTI0_IRQHandler(void);
+void I2C2_EV_IRQHandler(void);
+void I2C2_ER_IRQHandler(void);
+
+void HAL_GPIO_Init(GPIO_TypeDef *GPIOx, GPIO_InitTypeDef *GPIO_Init);
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin);
+void HAL_GPIO_WritePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState);
+void HAL_GPIO_TogglePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin);
+void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin);
+
+HAL_StatusTypeDef HAL_ADC_ConfigChannel(ADC_HandleTypeDef *hadc, ADC_ChannelConfTypeDef *sConfig);
+HAL_StatusTypeDef HAL_ADC_Start(ADC_HandleTypeDef *hadc);
+HAL_StatusTypeDef HAL_ADC_Stop(ADC_HandleTypeDef *hadc);
+HAL_StatusTypeDef HAL_ADC_PollForConversion(ADC_HandleTypeDef *hadc, uint32_t Timeout);
+uint32_t HAL_ADC_GetValue(ADC_HandleTypeDef *hadc);
+
+/* Simulator */
+void sim_init(const sim_cfg_t *p_cfg);
+DWT_Type *sim_dwt(void);
+DMA_Channel_TypeDef *sim_dma_channel(uint32_t channel);
+void sim_asm(const char *p_instr);
+void sim_wfi(void);
+void sim_busy(uint32_t cycles);
+uint32_t sim_time_ms(void);
+uint64_t sim_cycles(void);
+
+void sim_pin_set(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState);
+GPIO_PinState sim_pin_get(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin);
+void sim_exti_falling_enable(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin);
+void sim_adc_set(uint32_t channel, uint32_t value);
+
+int sim_snprintf(char *p_str, size_t size, const char *p_fmt, ...);
+int sim_sprintf(char *p_str, const char *p_fmt, ...);
+
+/********************** End of CPP guard *************************************/
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SIM_INC_SIM_HAL_H_ */
+
+/********************** end of file ******************************************/
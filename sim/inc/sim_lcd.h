@@ -0,0 +1,57 @@
+/*
+ * sim_lcd.h
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#ifndef SIM_INC_SIM_LCD_H_
+#define SIM_INC_SIM_LCD_H_
+
+/********************** CPP guard ********************************************/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/********************** inclusions *******************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/********************** macros ***********************************************/
+#define SIM_LCD_COLS			(16)
+#define SIM_LCD_ROWS			(2)
+
+/********************** typedef **********************************************/
+
+/********************** external data declaration ****************************/
+
+/********************** external functions declaration ***********************/
+/* HD44780 16x2, data = D7..D0 (D0..D3 as 0 when wired in 4-bit mode): latches
+ * on the falling edge of EN, every change is checked against the datasheet
+ * timings at sim_cycles(). input = D7..D0 pins configured as MCU inputs: every
+ * data pin must be an input on reads (no bus contention), D4..D7 outputs on
+ * writes */
+void sim_lcd_init(void);
+void sim_lcd_bus(bool rs, bool rw, bool en, uint8_t data, uint8_t input);
+
+/* D7..D0 driven by the controller while EN is high with RW = 1: BF and the
+ * address counter (in 4 bits, high nibble then low nibble on D7..D4) */
+uint8_t sim_lcd_read(void);
+
+/* PCF8574 backpack: one port byte (P0 RS, P2 EN, P4..P7 D4..D7, see board.h) */
+void sim_lcd_pcf8574_write(uint8_t port);
+
+/* Visible text of a row, SIM_LCD_COLS characters + '\0' (glyphs as '?') */
+void sim_lcd_row(uint32_t row, char *p_text);
+void sim_lcd_log(void);
+
+/* Timing, busy, garbage and off-screen violations so far (0 = clean bus) */
+uint32_t sim_lcd_violations(void);
+
+/********************** End of CPP guard *************************************/
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SIM_INC_SIM_LCD_H_ */
+
+/********************** end of file ******************************************/
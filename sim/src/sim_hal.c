@@ -0,0 +1,887 @@
+/*
+ * sim_hal.c
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+/* Fake HAL for the host simulation build.
+ *
+ * Simulated time is counted in target cycles (64 MHz). Code runs at host
+ * speed and the host time it takes is charged to the simulated clock
+ * (scaled by cpu_scale), while sleeping (WFI) and HAL_Delay() jump straight
+ * to the next tick, so idle and blocking waits cost no host time.
+ * Interrupts (SysTick, EXTI, I2C2) are taken at the next simulator step
+ * (CYCCNT read, HAL call, WFI or "CPSIE i") unless PRIMASK is set. PendSV
+ * has the lowest priority: it runs once no other interrupt is active and
+ * can be preempted by them. */
+
+/********************** inclusions *******************************************/
+#include <stdarg.h>
+#include <time.h>
+
+#include "main.h"
+
+#undef snprintf
+#undef sprintf
+
+/********************** macros and definitions *******************************/
+#define SIM_CYCLES_PER_TICK		(SIM_CPU_HZ / SIM_TICK_HZ)
+#define SIM_FMT_MAXLEN			(128)
+#define SIM_I2C_DR_EMPTY		(0xFFFFFFFFul)	// DR not written since the last byte was taken
+#define SIM_I2C_BYTE_BITS		(9ul)			// 8 data bits + ACK
+#define SIM_I2C_DMA_CHANNEL		(3)				// DMA1 channel 4 (I2C2_TX)
+
+/********************** internal data declaration ****************************/
+typedef enum
+{
+	SIM_I2C_IDLE,
+	SIM_I2C_START,					// START condition on the bus
+	SIM_I2C_SB,						// SB set, waiting for the address in DR
+	SIM_I2C_ADDRESS,				// Address byte on the bus
+	SIM_I2C_ADDR,					// ADDR set, waiting for the event handler
+	SIM_I2C_DATA,					// Data byte on the bus
+	SIM_I2C_HALT					// BTF or AF set, waiting for STOP
+} sim_i2c_st_t;
+
+typedef struct
+{
+	uint64_t	cycles;				// Simulated time (target cycles)
+	double		cycles_frac;		// Fraction carried from the host clock
+	uint64_t	tick_next;			// Simulated time of the next SysTick
+	uint32_t	ms;					// Simulated ticks elapsed
+	uint64_t	host_last_ns;		// Host clock at the last step
+	uint64_t	dwt_last;			// Simulated time already added to CYCCNT
+	bool		primask;			// "CPSID i"
+	bool		in_isr;
+	bool		in_pendsv;
+	uint32_t	tick_pending;
+	uint16_t	exti_pending;
+	uint32_t	adc_channel;
+	uint32_t	adc_value[SIM_ADC_CHANNEL_QTY];
+	uint64_t	adc_eoc;			// Simulated time the conversion ends
+	bool		tim_running;		// TIM2 CEN seen set
+	uint64_t	tim_update_next;	// Simulated time of the next TIM2 update
+	uint64_t	tim_cc1_next;		// Simulated time of the next CC1 match
+	uint32_t	dma_index[SIM_DMA_CHANNEL_QTY];	// Words moved since EN was set
+	sim_i2c_st_t i2c_state;
+	uint64_t	i2c_next;			// Simulated time the current I2C phase ends
+	uint8_t		i2c_addr;			// 7-bit address of the transfer
+	uint8_t		i2c_byte;			// Byte on the bus (SIM_I2C_DATA)
+	bool		i2c_ev_pending;		// I2C2 event interrupt raised
+	bool		i2c_er_pending;		// I2C2 error interrupt raised
+	bool		i2c_locked;			// START with SDA low: BUSY until SWRST
+} sim_dta_t;
+
+/********************** internal functions declaration ***********************/
+static void sim_step(void);
+
+/********************** internal data definition *****************************/
+static sim_cfg_t sim_cfg = { 1.0, SIM_DWT_READ_CYC_INI, NULL, NULL, NULL };
+static sim_dta_t sim_dta;
+static DWT_Type sim_dwt_regs;
+static uint32_t sim_uw_tick;
+
+/********************** external data declaration ****************************/
+uint32_t SystemCoreClock = SIM_CPU_HZ;
+GPIO_TypeDef sim_gpio[SIM_GPIO_PORT_QTY];
+CoreDebug_Type sim_core_debug;
+DBGMCU_TypeDef sim_dbgmcu;
+SCB_Type sim_scb;
+RCC_TypeDef sim_rcc;
+TIM_TypeDef sim_tim2;
+DMA_TypeDef sim_dma1;
+DMA_Channel_TypeDef sim_dma1_channel[SIM_DMA_CHANNEL_QTY];
+I2C_TypeDef sim_i2c2;
+EXTI_TypeDef sim_exti;
+AFIO_TypeDef sim_afio;
+
+/********************** internal functions definition ************************/
+static uint64_t sim_host_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return ((uint64_t)ts.tv_sec * 1000000000ull) + (uint64_t)ts.tv_nsec;
+}
+
+static void sim_gpio_odr_write(GPIO_TypeDef *GPIOx, uint32_t odr)
+{
+	uint32_t odr_old = GPIOx->ODR;
+
+	GPIOx->ODR = odr;
+
+	if ((odr_old != odr) && (NULL != sim_cfg.gpio_hook))
+	{
+		sim_cfg.gpio_hook(GPIOx, odr_old, odr);
+	}
+}
+
+/* BSRR/BRR writes done straight to the registers */
+static void sim_gpio_latch(void)
+{
+	uint32_t index;
+	uint32_t odr;
+	GPIO_TypeDef *p_port;
+
+	for (index = 0; SIM_GPIO_PORT_QTY > index; index++)
+	{
+		p_port = &sim_gpio[index];
+
+		if ((0 != p_port->BSRR) || (0 != p_port->BRR))
+		{
+			odr = p_port->ODR & ~((p_port->BSRR >> 16) | p_port->BRR);
+			odr |= (p_port->BSRR & 0xFFFFul);
+			p_port->BSRR = 0;
+			p_port->BRR = 0;
+			sim_gpio_odr_write(p_port, odr);
+		}
+	}
+}
+
+/* One DMA request: the next 32-bit word of the channel is written to its
+ * peripheral (a GPIO BSRR), at the simulated time of the timer event */
+static void sim_dma_request(uint32_t channel, uint64_t at)
+{
+	DMA_Channel_TypeDef *p_ch = &sim_dma1_channel[channel];
+	const uint32_t *p_src;
+	uint64_t now;
+
+	if (!(p_ch->CCR & DMA_CCR_EN) || (0 == p_ch->CNDTR))
+	{
+		return;
+	}
+
+	p_src = (const uint32_t *)p_ch->CMAR;
+	if (p_ch->CCR & DMA_CCR_MINC)
+	{
+		p_src += sim_dta.dma_index[channel];
+	}
+	*(volatile uint32_t *)p_ch->CPAR = *p_src;
+	sim_dta.dma_index[channel]++;
+
+	if (0 == --p_ch->CNDTR)
+	{
+		sim_dma1.ISR |= 0x2ul << (4 * channel);		// TCIFx
+	}
+
+	now = sim_dta.cycles;
+	sim_dta.cycles = at;
+	sim_gpio_latch();
+	sim_dta.cycles = now;
+}
+
+/* TIM2 events due up to now, in time order, each one feeding its DMA channel */
+static void sim_tim_step(void)
+{
+	uint32_t channel;
+	uint64_t period;
+	uint64_t prescaler;
+
+	for (channel = 0; SIM_DMA_CHANNEL_QTY > channel; channel++)
+	{
+		if (!(sim_dma1_channel[channel].CCR & DMA_CCR_EN))
+		{
+			sim_dta.dma_index[channel] = 0;
+		}
+	}
+
+	if (!(sim_tim2.CR1 & TIM_CR1_CEN))
+	{
+		sim_dta.tim_running = false;
+		return;
+	}
+
+	prescaler = (uint64_t)sim_tim2.PSC + 1;
+	period = ((uint64_t)sim_tim2.ARR + 1) * prescaler;
+
+	if (!sim_dta.tim_running)
+	{
+		/* Counting from CNT = 0 since this step */
+		sim_dta.tim_running = true;
+		sim_dta.tim_update_next = sim_dta.cycles + period;
+		sim_dta.tim_cc1_next = sim_dta.cycles + ((uint64_t)sim_tim2.CCR1 * prescaler);
+	}
+
+	for (;;)
+	{
+		if ((sim_dta.tim_cc1_next <= sim_dta.tim_update_next) && (sim_dta.tim_cc1_next <= sim_dta.cycles))
+		{
+			if (sim_tim2.DIER & TIM_DIER_CC1DE)
+			{
+				sim_dma_request(4, sim_dta.tim_cc1_next);	// Channel 5
+			}
+			sim_dta.tim_cc1_next += period;
+		}
+		else if (sim_dta.tim_update_next <= sim_dta.cycles)
+		{
+			if (sim_tim2.DIER & TIM_DIER_UDE)
+			{
+				sim_dma_request(1, sim_dta.tim_update_next);	// Channel 2
+			}
+			sim_dta.tim_update_next += period;
+		}
+		else
+		{
+			break;
+		}
+	}
+}
+
+/* Next byte to transmit: written by the CPU to DR, or moved by DMA1 channel 4
+ * on TXE (8-bit, memory to peripheral) */
+static bool sim_i2c_load(void)
+{
+	DMA_Channel_TypeDef *p_ch = &sim_dma1_channel[SIM_I2C_DMA_CHANNEL];
+
+	if (SIM_I2C_DR_EMPTY != sim_i2c2.DR)
+	{
+		sim_dta.i2c_byte = (uint8_t)sim_i2c2.DR;
+		sim_i2c2.DR = SIM_I2C_DR_EMPTY;
+		return true;
+	}
+
+	if ((sim_i2c2.CR2 & I2C_CR2_DMAEN) && (p_ch->CCR & DMA_CCR_EN) && (0 < p_ch->CNDTR))
+	{
+		sim_dta.i2c_byte = ((const uint8_t *)p_ch->CMAR)[sim_dta.dma_index[SIM_I2C_DMA_CHANNEL]++];
+		if (0 == --p_ch->CNDTR)
+		{
+			sim_dma1.ISR |= 0x2ul << (4 * SIM_I2C_DMA_CHANNEL);		// TCIF4
+		}
+		return true;
+	}
+
+	return false;
+}
+
+/* Hand a byte to the slave at the simulated time it completes on the bus */
+static bool sim_i2c_byte(int32_t byte, uint64_t at)
+{
+	uint64_t now;
+	bool ack;
+
+	if (NULL == sim_cfg.i2c_hook)
+	{
+		return false;
+	}
+
+	now = sim_dta.cycles;
+	sim_dta.cycles = at;
+	ack = sim_cfg.i2c_hook(sim_dta.i2c_addr, byte);
+	sim_dta.cycles = now;
+
+	return ack;
+}
+
+/* SCL period in simulated cycles, standard mode: 2 * CCR PCLK1 cycles
+ * (PCLK1 in MHz from CR2 FREQ). 0 = I2C2 not configured */
+static uint64_t sim_i2c_bit_cycles(void)
+{
+	uint32_t freq = sim_i2c2.CR2 & I2C_CR2_FREQ;
+
+	if (!(sim_i2c2.CR1 & I2C_CR1_PE) || (0 == freq))
+	{
+		return 0;
+	}
+
+	return (2ull * (sim_i2c2.CCR & I2C_CCR_CCR) * SIM_CPU_HZ) / (freq * 1000000ull);
+}
+
+/* I2C2 master transmitter, phases due up to now */
+static void sim_i2c_step(void)
+{
+	uint64_t byte_cycles;
+	uint64_t bit;
+
+	bit = sim_i2c_bit_cycles();
+	if (0 == bit)
+	{
+		sim_i2c2.SR2 = 0;
+		sim_dta.i2c_locked = false;
+		sim_dta.i2c_state = SIM_I2C_IDLE;
+		return;
+	}
+	byte_cycles = SIM_I2C_BYTE_BITS * bit;
+
+	if ((sim_i2c2.CR1 & I2C_CR1_STOP) && (SIM_I2C_IDLE != sim_dta.i2c_state))
+	{
+		sim_i2c2.CR1 &= ~I2C_CR1_STOP;
+		sim_i2c2.SR1 = 0;
+		sim_i2c2.SR2 = 0;
+		sim_i2c2.DR = SIM_I2C_DR_EMPTY;
+		sim_dta.i2c_state = SIM_I2C_IDLE;
+		return;
+	}
+
+	switch (sim_dta.i2c_state)
+	{
+		case SIM_I2C_IDLE:
+			sim_i2c2.CR1 &= ~I2C_CR1_STOP;
+			if (sim_i2c2.CR1 & I2C_CR1_START)
+			{
+				/* SDA held low by a slave: no START, and BUSY stays set even
+				 * after SDA is released (only SWRST or PE = 0 clears it) */
+				if (sim_dta.i2c_locked || !sim_i2c_byte(SIM_I2C_HOOK_START, sim_dta.cycles))
+				{
+					sim_i2c2.SR2 |= I2C_SR2_BUSY;
+					sim_dta.i2c_locked = true;
+					break;
+				}
+
+				sim_i2c2.CR1 &= ~I2C_CR1_START;
+				sim_i2c2.SR2 |= I2C_SR2_MSL | I2C_SR2_BUSY;
+				sim_i2c2.DR = SIM_I2C_DR_EMPTY;
+				sim_dta.i2c_next = sim_dta.cycles + bit;
+				sim_dta.i2c_state = SIM_I2C_START;
+			}
+			break;
+
+		case SIM_I2C_START:
+			if (sim_dta.cycles >= sim_dta.i2c_next)
+			{
+				sim_i2c2.SR1 |= I2C_SR1_SB;
+				sim_dta.i2c_ev_pending = true;
+				sim_dta.i2c_state = SIM_I2C_SB;
+			}
+			break;
+
+		case SIM_I2C_SB:
+			if (SIM_I2C_DR_EMPTY != sim_i2c2.DR)
+			{
+				sim_dta.i2c_addr = (uint8_t)(sim_i2c2.DR >> 1);
+				sim_i2c2.DR = SIM_I2C_DR_EMPTY;
+				sim_i2c2.SR1 &= ~I2C_SR1_SB;
+				sim_dta.i2c_next = sim_dta.cycles + byte_cycles;
+				sim_dta.i2c_state = SIM_I2C_ADDRESS;
+			}
+			break;
+
+		case SIM_I2C_ADDRESS:
+			if (sim_dta.cycles >= sim_dta.i2c_next)
+			{
+				if (sim_i2c_byte(SIM_I2C_HOOK_ADDR, sim_dta.i2c_next))
+				{
+					sim_i2c2.SR1 |= I2C_SR1_ADDR | I2C_SR1_TXE;
+					sim_dta.i2c_ev_pending = true;
+					sim_dta.i2c_state = SIM_I2C_ADDR;
+				}
+				else
+				{
+					sim_i2c2.SR1 |= I2C_SR1_AF;
+					sim_dta.i2c_er_pending = true;
+					sim_dta.i2c_state = SIM_I2C_HALT;
+				}
+			}
+			break;
+
+		case SIM_I2C_DATA:
+			while (sim_dta.cycles >= sim_dta.i2c_next)
+			{
+				(void)sim_i2c_byte(sim_dta.i2c_byte, sim_dta.i2c_next);
+
+				if (!sim_i2c_load())
+				{
+					/* Shift register and DR empty */
+					sim_i2c2.SR1 |= I2C_SR1_BTF | I2C_SR1_TXE;
+					sim_dta.i2c_ev_pending = true;
+					sim_dta.i2c_state = SIM_I2C_HALT;
+					break;
+				}
+				sim_dta.i2c_next += byte_cycles;
+			}
+			break;
+
+		default:
+			break;
+	}
+}
+
+/* EV6 done by the handler: the first data byte goes out right away */
+static void sim_i2c_addr_clear(void)
+{
+	sim_i2c2.SR1 &= ~I2C_SR1_ADDR;
+
+	if (sim_i2c_load())
+	{
+		sim_dta.i2c_next = sim_dta.cycles + (SIM_I2C_BYTE_BITS * sim_i2c_bit_cycles());
+		sim_dta.i2c_state = SIM_I2C_DATA;
+	}
+	else
+	{
+		sim_i2c2.SR1 |= I2C_SR1_BTF;
+		sim_dta.i2c_ev_pending = true;
+		sim_dta.i2c_state = SIM_I2C_HALT;
+	}
+}
+
+static void sim_irq_service(void)
+{
+	uint32_t line;
+	uint16_t pending;
+
+	if (sim_dta.primask || sim_dta.in_isr)
+	{
+		return;
+	}
+
+	sim_dta.in_isr = true;
+
+	while (0 < sim_dta.tick_pending)
+	{
+		sim_dta.tick_pending--;
+
+		/* SysTick_Handler() */
+		HAL_IncTick();
+		HAL_SYSTICK_Callback();
+	}
+
+	while (0 != sim_dta.exti_pending)
+	{
+		pending = sim_dta.exti_pending;
+		sim_dta.exti_pending = 0;
+
+		for (line = 0; 16 > line; line++)
+		{
+			if ((0 == line) && (pending & 1u))
+			{
+				EXTI0_IRQHandler();
+			}
+			else if (pending & (1u << line))
+			{
+				HAL_GPIO_EXTI_Callback((uint16_t)(1u << line));
+			}
+		}
+	}
+
+	/* I2C2: one handler call per flag raised, while its interrupt is enabled */
+	if (sim_dta.i2c_er_pending && (sim_i2c2.CR2 & I2C_CR2_ITERREN))
+	{
+		sim_dta.i2c_er_pending = false;
+		I2C2_ER_IRQHandler();
+	}
+
+	if (sim_dta.i2c_ev_pending && (sim_i2c2.CR2 & I2C_CR2_ITEVTEN))
+	{
+		sim_dta.i2c_ev_pending = false;
+		I2C2_EV_IRQHandler();
+
+		if ((SIM_I2C_ADDR == sim_dta.i2c_state) && (sim_i2c2.SR1 & I2C_SR1_ADDR))
+		{
+			sim_i2c_addr_clear();
+		}
+	}
+
+	sim_dta.in_isr = false;
+
+	/* Tail-chained PendSV, not reentrant */
+	while ((sim_scb.ICSR & SCB_ICSR_PENDSVSET_Msk) && !sim_dta.in_pendsv && !sim_dta.primask)
+	{
+		sim_scb.ICSR &= ~SCB_ICSR_PENDSVSET_Msk;
+		sim_dta.in_pendsv = true;
+		PendSV_Handler();
+		sim_dta.in_pendsv = false;
+	}
+}
+
+/* Charge the host time since the last step, then take the due interrupts */
+static void sim_step(void)
+{
+	uint64_t now_ns;
+	double cycles;
+
+	now_ns = sim_host_ns();
+	cycles = (double)(now_ns - sim_dta.host_last_ns) * ((double)SIM_CPU_HZ / 1e9) * sim_cfg.cpu_scale;
+	sim_dta.host_last_ns = now_ns;
+
+	cycles += sim_dta.cycles_frac;
+	sim_dta.cycles += (uint64_t)cycles;
+	sim_dta.cycles_frac = cycles - (double)(uint64_t)cycles;
+
+	if (sim_dwt_regs.CTRL & DWT_CTRL_CYCCNTENA_Msk)
+	{
+		sim_dwt_regs.CYCCNT += (uint32_t)(sim_dta.cycles - sim_dta.dwt_last);
+	}
+	sim_dta.dwt_last = sim_dta.cycles;
+
+	sim_tim_step();
+	sim_i2c_step();
+	sim_gpio_latch();
+
+	while (sim_dta.cycles >= sim_dta.tick_next)
+	{
+		sim_dta.tick_next += SIM_CYCLES_PER_TICK;
+		sim_dta.ms++;
+		sim_dta.tick_pending++;
+
+		if (NULL != sim_cfg.tick_hook)
+		{
+			sim_cfg.tick_hook(sim_dta.ms);
+		}
+	}
+
+	sim_irq_service();
+}
+
+/* Jump to the next tick: the CPU is asleep or spinning on the tick */
+static void sim_warp(void)
+{
+	sim_step();
+
+	if (sim_dta.cycles < sim_dta.tick_next)
+	{
+		sim_dta.cycles = sim_dta.tick_next;
+	}
+
+	sim_step();
+}
+
+/* Remove the "l" length modifier: target longs are 32 bits wide */
+static const char *sim_fmt_ilp32(char *p_dst, const char *p_fmt)
+{
+	size_t len = 0;
+
+	while (('\0' != *p_fmt) && ((SIM_FMT_MAXLEN - 1) > len))
+	{
+		p_dst[len++] = *p_fmt;
+
+		if ('%' == *p_fmt++)
+		{
+			while (('\0' != *p_fmt) && (NULL != strchr("-+ #0123456789.*", *p_fmt)) && ((SIM_FMT_MAXLEN - 1) > len))
+			{
+				p_dst[len++] = *p_fmt++;
+			}
+			if (('l' == p_fmt[0]) && ('l' != p_fmt[1]))
+			{
+				p_fmt++;
+			}
+		}
+	}
+	p_dst[len] = '\0';
+
+	return p_dst;
+}
+
+/********************** external functions definition ************************/
+void sim_init(const sim_cfg_t *p_cfg)
+{
+	sim_cfg = *p_cfg;
+
+	memset(&sim_dta, 0, sizeof(sim_dta));
+	memset(sim_gpio, 0, sizeof(sim_gpio));
+	memset(&sim_dwt_regs, 0, sizeof(sim_dwt_regs));
+	memset(&sim_scb, 0, sizeof(sim_scb));
+	memset(&sim_rcc, 0, sizeof(sim_rcc));
+	memset(&sim_tim2, 0, sizeof(sim_tim2));
+	memset(&sim_dma1, 0, sizeof(sim_dma1));
+	memset(sim_dma1_channel, 0, sizeof(sim_dma1_channel));
+	memset(&sim_i2c2, 0, sizeof(sim_i2c2));
+	memset(&sim_exti, 0, sizeof(sim_exti));
+	memset(&sim_afio, 0, sizeof(sim_afio));
+	sim_i2c2.DR = SIM_I2C_DR_EMPTY;
+
+	sim_dta.tick_next = SIM_CYCLES_PER_TICK;
+	sim_dta.host_last_ns = sim_host_ns();
+	sim_uw_tick = 0;
+}
+
+DWT_Type *sim_dwt(void)
+{
+	sim_dta.cycles += sim_cfg.dwt_read_cycles;
+	sim_step();
+
+	return &sim_dwt_regs;
+}
+
+DMA_Channel_TypeDef *sim_dma_channel(uint32_t channel)
+{
+	sim_step();
+
+	return &sim_dma1_channel[channel - 1];
+}
+
+void sim_asm(const char *p_instr)
+{
+	if (0 == strcmp(p_instr, "CPSID i"))
+	{
+		sim_dta.primask = true;
+	}
+	else if (0 == strcmp(p_instr, "CPSIE i"))
+	{
+		sim_dta.primask = false;
+		sim_step();
+	}
+}
+
+void sim_wfi(void)
+{
+	/* WFI wakes up on a pending interrupt even with PRIMASK set */
+	sim_step();
+
+	if ((0 == sim_dta.tick_pending) && (0 == sim_dta.exti_pending))
+	{
+		sim_warp();
+	}
+}
+
+void sim_busy(uint32_t cycles)
+{
+	sim_dta.cycles += cycles;
+	sim_step();
+}
+
+uint32_t sim_time_ms(void)
+{
+	return sim_dta.ms;
+}
+
+uint64_t sim_cycles(void)
+{
+	return sim_dta.cycles;
+}
+
+void sim_pin_set(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState)
+{
+	uint32_t line;
+	uint32_t edge;
+	uint32_t idr_old;
+
+	idr_old = GPIOx->IDR;
+
+	if (GPIO_PIN_SET == PinState)
+	{
+		GPIOx->IDR |= GPIO_Pin;
+		edge = sim_exti.RTSR;
+	}
+	else
+	{
+		GPIOx->IDR &= ~(uint32_t)GPIO_Pin;
+		edge = sim_exti.FTSR;
+	}
+
+	/* Lines whose level changed, routed to this port, unmasked, on this edge */
+	for (line = 0; 16 > line; line++)
+	{
+		if (((idr_old ^ GPIOx->IDR) & (1u << line)) && (edge & sim_exti.IMR & (1u << line)) &&
+			(GPIO_GET_INDEX(GPIOx) == ((sim_afio.EXTICR[line >> 2] >> ((line & 3u) * 4u)) & 0x0Fu)))
+		{
+			sim_dta.exti_pending |= (uint16_t)(1u << line);
+		}
+	}
+}
+
+GPIO_PinState sim_pin_get(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin)
+{
+	sim_gpio_latch();
+
+	return (0 != (GPIOx->ODR & GPIO_Pin)) ? GPIO_PIN_SET : GPIO_PIN_RESET;
+}
+
+void sim_exti_falling_enable(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin)
+{
+	uint32_t line;
+
+	/* What HAL_GPIO_Init() does for GPIO_MODE_IT_FALLING */
+	for (line = 0; 16 > line; line++)
+	{
+		if (GPIO_Pin & (1u << line))
+		{
+			sim_afio.EXTICR[line >> 2] &= ~(0x0Fu << ((line & 3u) * 4u));
+			sim_afio.EXTICR[line >> 2] |= GPIO_GET_INDEX(GPIOx) << ((line & 3u) * 4u);
+			sim_exti.FTSR |= (1u << line);
+			sim_exti.IMR |= (1u << line);
+		}
+	}
+}
+
+void sim_adc_set(uint32_t channel, uint32_t value)
+{
+	if (SIM_ADC_CHANNEL_QTY > channel)
+	{
+		sim_dta.adc_value[channel] = value & 0x0FFFul;
+	}
+}
+
+int sim_snprintf(char *p_str, size_t size, const char *p_fmt, ...)
+{
+	char fmt[SIM_FMT_MAXLEN];
+	va_list args;
+	int len;
+
+	va_start(args, p_fmt);
+	len = vsnprintf(p_str, size, sim_fmt_ilp32(fmt, p_fmt), args);
+	va_end(args);
+
+	return len;
+}
+
+int sim_sprintf(char *p_str, const char *p_fmt, ...)
+{
+	char fmt[SIM_FMT_MAXLEN];
+	va_list args;
+	int len;
+
+	va_start(args, p_fmt);
+	len = vsprintf(p_str, sim_fmt_ilp32(fmt, p_fmt), args);
+	va_end(args);
+
+	return len;
+}
+
+/* HAL */
+HAL_StatusTypeDef HAL_Init(void)
+{
+	return HAL_OK;
+}
+
+uint32_t HAL_GetTick(void)
+{
+	sim_step();
+
+	return sim_uw_tick;
+}
+
+void HAL_IncTick(void)
+{
+	sim_uw_tick++;
+}
+
+void HAL_Delay(uint32_t Delay)
+{
+	uint32_t tickstart = HAL_GetTick();
+	uint32_t wait = Delay;
+
+	/* Same minimum wait as the HAL */
+	if (HAL_MAX_DELAY > wait)
+	{
+		wait++;
+	}
+
+	while ((HAL_GetTick() - tickstart) < wait)
+	{
+		sim_warp();
+	}
+}
+
+void HAL_GPIO_Init(GPIO_TypeDef *GPIOx, GPIO_InitTypeDef *GPIO_Init)
+{
+	uint32_t pin;
+	uint32_t config;
+	__IO uint32_t *p_cr;
+
+	sim_step();
+
+	/* CNF/MODE as the HAL writes them (MODE = speed on outputs) */
+	if (GPIO_MODE_INPUT == GPIO_Init->Mode)
+	{
+		config = (GPIO_NOPULL == GPIO_Init->Pull) ? 0x4ul : 0x8ul;
+	}
+	else if (GPIO_MODE_OUTPUT_PP == GPIO_Init->Mode)
+	{
+		config = GPIO_Init->Speed;
+	}
+	else if (GPIO_MODE_OUTPUT_OD == GPIO_Init->Mode)
+	{
+		config = 0x4ul | GPIO_Init->Speed;
+	}
+	else if (GPIO_MODE_AF_OD == GPIO_Init->Mode)
+	{
+		config = 0xCul | GPIO_Init->Speed;
+	}
+	else
+	{
+		return;
+	}
+
+	for (pin = 0; 16 > pin; pin++)
+	{
+		if (GPIO_Init->Pin & (1ul << pin))
+		{
+			p_cr = (8 > pin) ? &GPIOx->CRL : &GPIOx->CRH;
+			*p_cr = (*p_cr & ~(0xFul << ((pin & 7ul) * 4ul))) | (config << ((pin & 7ul) * 4ul));
+		}
+	}
+}
+
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin)
+{
+	sim_step();
+
+	return (0 != (GPIOx->IDR & GPIO_Pin)) ? GPIO_PIN_SET : GPIO_PIN_RESET;
+}
+
+void HAL_GPIO_WritePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState)
+{
+	sim_step();
+
+	if (GPIO_PIN_SET == PinState)
+	{
+		sim_gpio_odr_write(GPIOx, GPIOx->ODR | GPIO_Pin);
+	}
+	else
+	{
+		sim_gpio_odr_write(GPIOx, GPIOx->ODR & ~(uint32_t)GPIO_Pin);
+	}
+}
+
+void HAL_GPIO_TogglePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin)
+{
+	sim_step();
+
+	sim_gpio_odr_write(GPIOx, GPIOx->ODR ^ GPIO_Pin);
+}
+
+void HAL_NVIC_SetPriority(IRQn_Type IRQn, uint32_t PreemptPriority, uint32_t SubPriority)
+{
+	/* Fixed model: SysTick & EXTI, then I2C2, above PendSV */
+}
+
+void HAL_NVIC_EnableIRQ(IRQn_Type IRQn)
+{
+	/* Peripheral interrupts are gated by their own enable bits only */
+}
+
+HAL_StatusTypeDef HAL_ADC_ConfigChannel(ADC_HandleTypeDef *hadc, ADC_ChannelConfTypeDef *sConfig)
+{
+	sim_step();
+	sim_dta.adc_channel = sConfig->Channel;
+
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_ADC_Start(ADC_HandleTypeDef *hadc)
+{
+	sim_step();
+	sim_dta.adc_eoc = sim_cycles() + SIM_ADC_CONV_CYCLES;
+
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_ADC_Stop(ADC_HandleTypeDef *hadc)
+{
+	sim_step();
+
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_ADC_PollForConversion(ADC_HandleTypeDef *hadc, uint32_t Timeout)
+{
+	uint64_t now = sim_cycles();
+
+	/* 239.5 + 12.5 ADC clocks from HAL_ADC_Start(): only the part still
+	 * running blocks */
+	if (sim_dta.adc_eoc > now)
+	{
+		sim_busy((uint32_t)(sim_dta.adc_eoc - now));
+	}
+
+	return HAL_OK;
+}
+
+uint32_t HAL_ADC_GetValue(ADC_HandleTypeDef *hadc)
+{
+	sim_step();
+
+	return (SIM_ADC_CHANNEL_QTY > sim_dta.adc_channel) ? sim_dta.adc_value[sim_dta.adc_channel] : 0ul;
+}
+
+/********************** end of file ******************************************/
@@ -0,0 +1,560 @@
+/*
+ * sim_lcd.c
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+/* HD44780 model for the host simulation: decodes the bus (GPIO pins or the
+ * PCF8574 port) into instructions and keeps DDRAM/CGRAM, so scenarios can
+ * check what the LCD shows whatever backend display.c uses.
+ *
+ * Every bus change is timestamped with sim_cycles() and checked against the
+ * datasheet minimums (HD44780, 5 V): RS setup, EN pulse width and cycle, data
+ * setup and hold, power-on and command execution times (a byte latched while
+ * the controller is busy is lost on a real LCD). Bytes written to DDRAM that
+ * are not printable or fall outside the 16x2 window are reported as well.
+ * The smallest margin seen on each parameter is logged, to tighten the
+ * timings of display.c without going below the datasheet. */
+
+/********************** inclusions *******************************************/
+#include "main.h"
+#include "board.h"
+#include "sim_lcd.h"
+
+/********************** macros and definitions *******************************/
+#define SIM_LCD_DDRAM_SIZE		(0x80)
+#define SIM_LCD_CGRAM_SIZE		(0x40)
+#define SIM_LCD_LINE2_ADDR		(0x40)
+
+/* Datasheet minimums */
+#define SIM_LCD_NS_TAS			(40)		// RS/RW setup -> EN high
+#define SIM_LCD_NS_PWEH			(450)		// EN high width
+#define SIM_LCD_NS_TCYCE		(1000)		// EN cycle (rise to rise)
+#define SIM_LCD_NS_TDSW			(195)		// Data setup -> EN low
+#define SIM_LCD_NS_TH			(10)		// Data/RS hold after EN low
+#define SIM_LCD_US_POWER_ON		(40000)		// Vcc -> first instruction
+#define SIM_LCD_US_RESET_1		(4100)		// After the first Function Set of the reset
+#define SIM_LCD_US_RESET_2		(100)		// After the second one
+#define SIM_LCD_US_EXEC_STD		(37)
+#define SIM_LCD_US_EXEC_CLEAR	(1520)		// Clear Display / Return Home
+
+/* Bus activity separated by more than this is another frame */
+#define SIM_LCD_FRAME_GAP_US	(10000)
+#define SIM_LCD_VIOLATION_LOG	(8)			// Violations printed one by one
+
+#define SIM_LCD_CYC_PER_US		(SIM_CPU_HZ / 1000000ul)
+#define SIM_LCD_NS(cycles)		((uint64_t)(cycles) * 1000ull / SIM_LCD_CYC_PER_US)
+
+/********************** internal data declaration ****************************/
+typedef enum
+{
+	SIM_LCD_V_TAS,
+	SIM_LCD_V_PWEH,
+	SIM_LCD_V_TCYCE,
+	SIM_LCD_V_TDSW,
+	SIM_LCD_V_TH,
+	SIM_LCD_V_BUSY,
+	SIM_LCD_V_GARBAGE,
+	SIM_LCD_V_OFFSCREEN,
+	SIM_LCD_V_BUS,
+	SIM_LCD_V_QTY
+} sim_lcd_violation_t;
+
+typedef struct
+{
+	bool		en;					// Bus levels at the last change
+	bool		rs;
+	bool		rw;
+	uint8_t		data;
+	uint64_t	t_ctrl;				// Last RS/RW change (cycles)
+	uint64_t	t_data;				// Last D0..D7 change
+	uint64_t	t_en_rise;
+	uint64_t	t_en_fall;
+	bool		en_pulsed;			// t_en_rise/t_en_fall are valid
+	uint64_t	busy_until;			// End of the instruction in execution
+	uint32_t	reset_cnt;			// Function Sets of the reset by instruction
+	bool		bus_8bit;			// Interface data length (DL): 8 bits after reset
+	bool		nibble_low;			// 4 bits: high nibble latched, low one pending
+	uint8_t		nibble_high;
+	bool		read_low;			// 4 bits: BF/AC6..AC4 read, AC3..AC0 pending
+	uint8_t		read_data;			// D7..D0 driven by the current read
+	uint8_t		ac;					// Address counter
+	bool		ac_cgram;			// AC points to CGRAM (Set CGRAM Address)
+	bool		increment;			// Entry mode I/D
+	bool		display_on;
+	uint8_t		ddram[SIM_LCD_DDRAM_SIZE];
+	uint8_t		cgram[SIM_LCD_CGRAM_SIZE];
+	uint32_t	instr_cnt;
+	uint32_t	data_cnt;
+} sim_lcd_dta_t;
+
+typedef struct
+{
+	uint32_t	cnt[SIM_LCD_V_QTY];
+	uint64_t	min_ns[SIM_LCD_V_QTY];	// Smallest value seen (timing checks)
+	bool		seen[SIM_LCD_V_QTY];
+	uint64_t	slack_min;				// Least idle time between an execution and the next latch
+	bool		slack_seen;
+	uint32_t	logged;
+} sim_lcd_check_t;
+
+typedef struct
+{
+	bool		open;
+	bool		boot;				// Frame with the power-up sequence
+	uint64_t	start;				// First EN pulse
+	uint64_t	end;				// Last instruction executed
+	uint32_t	bytes;
+	uint32_t	frames;
+	uint64_t	cycles;				// Bus time of every frame (boot excluded)
+	uint64_t	cycles_max;
+	uint32_t	bytes_total;
+	uint64_t	boot_cycles;
+} sim_lcd_frame_t;
+
+/********************** internal functions declaration ***********************/
+
+/********************** internal data definition *****************************/
+static sim_lcd_dta_t sim_lcd_dta;
+static sim_lcd_check_t sim_lcd_check;
+static sim_lcd_frame_t sim_lcd_frame;
+
+static const char * const sim_lcd_violation_name[SIM_LCD_V_QTY] =
+{
+	"tAS", "PWEH", "tcycE", "tDSW", "tH", "ocupado", "basura", "fuera de 16x2", "bus"
+};
+
+static const uint64_t sim_lcd_limit_ns[SIM_LCD_V_QTY] =
+{
+	SIM_LCD_NS_TAS, SIM_LCD_NS_PWEH, SIM_LCD_NS_TCYCE, SIM_LCD_NS_TDSW, SIM_LCD_NS_TH, 0, 0, 0, 0
+};
+
+/********************** external data declaration ****************************/
+
+/********************** internal functions definition ************************/
+static void sim_lcd_violation(sim_lcd_violation_t violation, uint64_t now, const char *p_detail)
+{
+	sim_lcd_check.cnt[violation]++;
+
+	if (SIM_LCD_VIOLATION_LOG > sim_lcd_check.logged)
+	{
+		sim_lcd_check.logged++;
+		printf("[SIM] LCD violacion %s en t = %lu us: %s\n", sim_lcd_violation_name[violation],
+			   (unsigned long)(now / SIM_LCD_CYC_PER_US), p_detail);
+	}
+}
+
+/* Timing check: records the smallest value and flags it below the minimum */
+static void sim_lcd_timing(sim_lcd_violation_t violation, uint64_t now, uint64_t cycles)
+{
+	char detail[48];
+	uint64_t ns = SIM_LCD_NS(cycles);
+
+	if (!sim_lcd_check.seen[violation] || (sim_lcd_check.min_ns[violation] > ns))
+	{
+		sim_lcd_check.min_ns[violation] = ns;
+		sim_lcd_check.seen[violation] = true;
+	}
+
+	if (sim_lcd_limit_ns[violation] > ns)
+	{
+		snprintf(detail, sizeof(detail), "%lu ns < %lu ns", (unsigned long)ns,
+				 (unsigned long)sim_lcd_limit_ns[violation]);
+		sim_lcd_violation(violation, now, detail);
+	}
+}
+
+static void sim_lcd_frame_close(void)
+{
+	uint64_t cycles;
+
+	if (!sim_lcd_frame.open)
+	{
+		return;
+	}
+
+	sim_lcd_frame.open = false;
+	cycles = sim_lcd_frame.end - sim_lcd_frame.start;
+
+	if (sim_lcd_frame.boot)
+	{
+		sim_lcd_frame.boot_cycles += cycles;
+		return;
+	}
+
+	sim_lcd_frame.frames++;
+	sim_lcd_frame.cycles += cycles;
+	sim_lcd_frame.bytes_total += sim_lcd_frame.bytes;
+	if (sim_lcd_frame.cycles_max < cycles)
+	{
+		sim_lcd_frame.cycles_max = cycles;
+	}
+}
+
+/* Execution time of an instruction or data write, in us */
+static uint32_t sim_lcd_exec_us(bool rs, uint8_t byte)
+{
+	if (rs || (byte & 0xFC))
+	{
+		return SIM_LCD_US_EXEC_STD;
+	}
+
+	return SIM_LCD_US_EXEC_CLEAR;
+}
+
+static void sim_lcd_execute(bool rs, uint8_t byte)
+{
+	char detail[48];
+	uint8_t col;
+
+	if (rs)
+	{
+		sim_lcd_dta.data_cnt++;
+
+		if (sim_lcd_dta.ac_cgram)
+		{
+			sim_lcd_dta.cgram[sim_lcd_dta.ac % SIM_LCD_CGRAM_SIZE] = byte;
+		}
+		else
+		{
+			/* Glyphs are used through their 0x08..0x0F aliases (DISPLAY_CGRAM_CHAR):
+			 * 0x00..0x07 is a leaked string terminator, 0x10..0x1F has no font */
+			if ((0x08 > byte) || ((0x10 <= byte) && (0x20 > byte)))
+			{
+				snprintf(detail, sizeof(detail), "0x%02X en DDRAM 0x%02X", byte, sim_lcd_dta.ac);
+				sim_lcd_violation(SIM_LCD_V_GARBAGE, sim_cycles(), detail);
+			}
+
+			col = sim_lcd_dta.ac & (SIM_LCD_LINE2_ADDR - 1);
+			if ((SIM_LCD_COLS <= col) || (SIM_LCD_ROWS <= (sim_lcd_dta.ac / SIM_LCD_LINE2_ADDR)))
+			{
+				snprintf(detail, sizeof(detail), "'%c' en DDRAM 0x%02X", (char)byte, sim_lcd_dta.ac);
+				sim_lcd_violation(SIM_LCD_V_OFFSCREEN, sim_cycles(), detail);
+			}
+
+			sim_lcd_dta.ddram[sim_lcd_dta.ac % SIM_LCD_DDRAM_SIZE] = byte;
+		}
+		sim_lcd_dta.ac = (uint8_t)(sim_lcd_dta.ac + (sim_lcd_dta.increment ? 1 : -1)) % SIM_LCD_DDRAM_SIZE;
+		return;
+	}
+
+	sim_lcd_dta.instr_cnt++;
+
+	if (byte & 0x80)			// Set DDRAM Address
+	{
+		sim_lcd_dta.ac = byte & 0x7F;
+		sim_lcd_dta.ac_cgram = false;
+	}
+	else if (byte & 0x40)		// Set CGRAM Address
+	{
+		sim_lcd_dta.ac = byte & 0x3F;
+		sim_lcd_dta.ac_cgram = true;
+	}
+	else if (byte & 0x20)		// Function Set
+	{
+		sim_lcd_dta.bus_8bit = (0 != (byte & 0x10));
+		sim_lcd_dta.nibble_low = false;
+		sim_lcd_frame.boot = true;
+	}
+	else if (byte & 0x08)		// Display Control
+	{
+		sim_lcd_dta.display_on = (0 != (byte & 0x04));
+	}
+	else if (byte & 0x04)		// Entry Mode Set
+	{
+		sim_lcd_dta.increment = (0 != (byte & 0x02));
+	}
+	else if (byte & 0x02)		// Return Home
+	{
+		sim_lcd_dta.ac = 0;
+		sim_lcd_dta.ac_cgram = false;
+	}
+	else if (byte & 0x01)		// Clear Display
+	{
+		memset(sim_lcd_dta.ddram, ' ', sizeof(sim_lcd_dta.ddram));
+		sim_lcd_dta.ac = 0;
+		sim_lcd_dta.ac_cgram = false;
+		sim_lcd_dta.increment = true;
+	}
+}
+
+/* First latch of an instruction: it must find the controller idle */
+static void sim_lcd_busy_check(uint64_t now, const char *p_detail)
+{
+	char detail[64];
+
+	if (now < sim_lcd_dta.busy_until)
+	{
+		snprintf(detail, sizeof(detail), "%s %lu us antes", p_detail,
+				 (unsigned long)((sim_lcd_dta.busy_until - now) / SIM_LCD_CYC_PER_US));
+		sim_lcd_violation(SIM_LCD_V_BUSY, now, detail);
+		return;
+	}
+
+	if (!sim_lcd_check.slack_seen || (sim_lcd_check.slack_min > (now - sim_lcd_dta.busy_until)))
+	{
+		sim_lcd_check.slack_min = now - sim_lcd_dta.busy_until;
+		sim_lcd_check.slack_seen = true;
+	}
+}
+
+/* A byte reached the controller: busy check, execution time and frame */
+static void sim_lcd_latch(bool rs, uint8_t byte, uint64_t now)
+{
+	char detail[48];
+	uint32_t exec_us;
+
+	/* In 4 bits the high nibble was already checked (busy_until did not move) */
+	if (sim_lcd_dta.bus_8bit)
+	{
+		snprintf(detail, sizeof(detail), "0x%02X (RS %u)", byte, rs ? 1u : 0u);
+		sim_lcd_busy_check(now, detail);
+	}
+
+	/* Reset by instruction: the first two Function Sets take longer */
+	exec_us = sim_lcd_exec_us(rs, byte);
+	if (!rs && (0x20 == (byte & 0xE0)) && (2 > sim_lcd_dta.reset_cnt))
+	{
+		exec_us = (0 == sim_lcd_dta.reset_cnt) ? SIM_LCD_US_RESET_1 : SIM_LCD_US_RESET_2;
+		sim_lcd_dta.reset_cnt++;
+	}
+
+	sim_lcd_dta.busy_until = now + ((uint64_t)exec_us * SIM_LCD_CYC_PER_US);
+	sim_lcd_frame.end = sim_lcd_dta.busy_until;
+	sim_lcd_frame.bytes++;
+
+	sim_lcd_execute(rs, byte);
+}
+
+/********************** external functions definition ************************/
+void sim_lcd_init(void)
+{
+	memset(&sim_lcd_dta, 0, sizeof(sim_lcd_dta));
+	memset(&sim_lcd_check, 0, sizeof(sim_lcd_check));
+	memset(&sim_lcd_frame, 0, sizeof(sim_lcd_frame));
+	memset(sim_lcd_dta.ddram, ' ', sizeof(sim_lcd_dta.ddram));
+	sim_lcd_dta.bus_8bit = true;
+	sim_lcd_dta.increment = true;
+
+	/* Vcc rises at t = 0: nothing may be latched before the power-on time */
+	sim_lcd_dta.busy_until = (uint64_t)SIM_LCD_US_POWER_ON * SIM_LCD_CYC_PER_US;
+}
+
+void sim_lcd_bus(bool rs, bool rw, bool en, uint8_t data, uint8_t input)
+{
+	char detail[32];
+	uint8_t value;
+	uint64_t now = sim_cycles();
+	bool rising = !sim_lcd_dta.en && en;
+	bool falling = sim_lcd_dta.en && !en;
+	bool ctrl_changed = (sim_lcd_dta.rs != rs) || (sim_lcd_dta.rw != rw);
+	bool data_changed = (sim_lcd_dta.data != data);
+
+	/* Hold: RS/RW and, on writes, the data must stay after EN falls (also when
+	 * they change in the same store that lowers EN) */
+	if ((falling || (sim_lcd_dta.en_pulsed && !en)) &&
+		(ctrl_changed || (data_changed && !rw && !sim_lcd_dta.rw)))
+	{
+		sim_lcd_timing(SIM_LCD_V_TH, now, falling ? 0 : (now - sim_lcd_dta.t_en_fall));
+	}
+
+	/* RS/RW may not change while EN is high */
+	if (ctrl_changed && sim_lcd_dta.en && en)
+	{
+		sim_lcd_violation(SIM_LCD_V_TAS, now, "RS/RW cambia con EN alto");
+	}
+
+	if (ctrl_changed)
+	{
+		sim_lcd_dta.t_ctrl = now;
+	}
+	if (data_changed)
+	{
+		sim_lcd_dta.t_data = now;
+	}
+	sim_lcd_dta.rs = rs;
+	sim_lcd_dta.rw = rw;
+	sim_lcd_dta.data = data;
+	sim_lcd_dta.en = en;
+
+	if (rising)
+	{
+		sim_lcd_timing(SIM_LCD_V_TAS, now, now - sim_lcd_dta.t_ctrl);
+		if (sim_lcd_dta.en_pulsed)
+		{
+			sim_lcd_timing(SIM_LCD_V_TCYCE, now, now - sim_lcd_dta.t_en_rise);
+		}
+		sim_lcd_dta.t_en_rise = now;
+
+		if (rw)
+		{
+			/* The controller drives D0..D7: none of them may be an output */
+			if (0xFF != input)
+			{
+				snprintf(detail, sizeof(detail), "lectura con D 0x%02X salida", (unsigned)(uint8_t)~input);
+				sim_lcd_violation(SIM_LCD_V_BUS, now, detail);
+			}
+
+			value = (uint8_t)(((now < sim_lcd_dta.busy_until) ? 0x80 : 0) | (sim_lcd_dta.ac & 0x7F));
+			if (!sim_lcd_dta.bus_8bit)
+			{
+				value = sim_lcd_dta.read_low ? (uint8_t)(value << 4) : (uint8_t)(value & 0xF0);
+			}
+			sim_lcd_dta.read_data = value;
+		}
+		else
+		{
+			if (0 != (input & 0xF0))
+			{
+				snprintf(detail, sizeof(detail), "escritura con D 0x%02X entrada", (unsigned)(input & 0xF0));
+				sim_lcd_violation(SIM_LCD_V_BUS, now, detail);
+			}
+
+			/* A new frame starts after a long idle bus */
+			if (sim_lcd_frame.open && (now > (sim_lcd_frame.end + (uint64_t)SIM_LCD_FRAME_GAP_US * SIM_LCD_CYC_PER_US)))
+			{
+				sim_lcd_frame_close();
+			}
+			if (!sim_lcd_frame.open)
+			{
+				sim_lcd_frame.open = true;
+				sim_lcd_frame.boot = false;
+				sim_lcd_frame.start = now;
+				sim_lcd_frame.end = now;
+				sim_lcd_frame.bytes = 0;
+			}
+		}
+		return;
+	}
+
+	if (!falling)
+	{
+		return;
+	}
+
+	sim_lcd_timing(SIM_LCD_V_PWEH, now, now - sim_lcd_dta.t_en_rise);
+	sim_lcd_dta.t_en_fall = now;
+	sim_lcd_dta.en_pulsed = true;
+
+	/* Reads (busy flag) do not latch anything */
+	if (rw)
+	{
+		if (!sim_lcd_dta.bus_8bit)
+		{
+			sim_lcd_dta.read_low = !sim_lcd_dta.read_low;
+		}
+		return;
+	}
+
+	sim_lcd_timing(SIM_LCD_V_TDSW, now, now - sim_lcd_dta.t_data);
+
+	if (sim_lcd_dta.bus_8bit)
+	{
+		/* With a 4-bit wiring D0..D3 are not driven: they read as 0 */
+		sim_lcd_latch(rs, data, now);
+	}
+	else if (!sim_lcd_dta.nibble_low)
+	{
+		/* The controller is busy for the whole instruction, both nibbles */
+		snprintf(detail, sizeof(detail), "nibble alto 0x%X (RS %u)", data >> 4, rs ? 1u : 0u);
+		sim_lcd_busy_check(now, detail);
+		sim_lcd_dta.nibble_high = data >> 4;
+		sim_lcd_dta.nibble_low = true;
+	}
+	else
+	{
+		sim_lcd_dta.nibble_low = false;
+		sim_lcd_latch(rs, (uint8_t)((sim_lcd_dta.nibble_high << 4) | (data >> 4)), now);
+	}
+}
+
+void sim_lcd_pcf8574_write(uint8_t port)
+{
+	sim_lcd_bus(0 != (port & LCD_I2C_BIT_RS), 0 != (port & LCD_I2C_BIT_RW), 0 != (port & LCD_I2C_BIT_EN),
+				(uint8_t)((port >> LCD_I2C_DATA_SHIFT) << 4), 0);
+}
+
+uint8_t sim_lcd_read(void)
+{
+	return sim_lcd_dta.read_data;
+}
+
+void sim_lcd_row(uint32_t row, char *p_text)
+{
+	uint32_t col;
+	uint8_t code;
+
+	for (col = 0; SIM_LCD_COLS > col; col++)
+	{
+		code = sim_lcd_dta.ddram[((0 < row) ? SIM_LCD_LINE2_ADDR : 0) + col];
+		p_text[col] = ((0x20 <= code) && (0x7F > code)) ? (char)code : '?';
+	}
+	p_text[SIM_LCD_COLS] = '\0';
+}
+
+uint32_t sim_lcd_violations(void)
+{
+	uint32_t total = 0;
+	uint32_t index;
+
+	for (index = 0; SIM_LCD_V_QTY > index; index++)
+	{
+		total += sim_lcd_check.cnt[index];
+	}
+
+	return total;
+}
+
+void sim_lcd_log(void)
+{
+	char text[SIM_LCD_COLS + 1];
+	uint32_t row;
+	uint32_t index;
+
+	sim_lcd_frame_close();
+
+	for (row = 0; SIM_LCD_ROWS > row; row++)
+	{
+		sim_lcd_row(row, text);
+		printf("[SIM] LCD %lu |%s|%s\n", (unsigned long)row, text, sim_lcd_dta.display_on ? "" : " (apagado)");
+	}
+	printf("[SIM] LCD %lu instrucciones, %lu datos\n",
+		   (unsigned long)sim_lcd_dta.instr_cnt, (unsigned long)sim_lcd_dta.data_cnt);
+
+	printf("[SIM] LCD bus: arranque %lu us, %lu cuadros, media/max %lu/%lu us, %lu bytes/cuadro\n",
+		   (unsigned long)(sim_lcd_frame.boot_cycles / SIM_LCD_CYC_PER_US),
+		   (unsigned long)sim_lcd_frame.frames,
+		   (unsigned long)((0 < sim_lcd_frame.frames) ?
+				   (sim_lcd_frame.cycles / sim_lcd_frame.frames / SIM_LCD_CYC_PER_US) : 0),
+		   (unsigned long)(sim_lcd_frame.cycles_max / SIM_LCD_CYC_PER_US),
+		   (unsigned long)((0 < sim_lcd_frame.frames) ? (sim_lcd_frame.bytes_total / sim_lcd_frame.frames) : 0));
+
+	/* Smallest margins: how far the timings of display.c can be tightened */
+	printf("[SIM] LCD minimos (ns):");
+	for (index = 0; SIM_LCD_V_TH >= index; index++)
+	{
+		printf(" %s %lu/%lu", sim_lcd_violation_name[index],
+			   (unsigned long)(sim_lcd_check.seen[index] ? sim_lcd_check.min_ns[index] : 0),
+			   (unsigned long)sim_lcd_limit_ns[index]);
+	}
+	printf(", ejecucion holgura %lu us\n",
+		   (unsigned long)(sim_lcd_check.slack_seen ? (sim_lcd_check.slack_min / SIM_LCD_CYC_PER_US) : 0));
+
+	if (0 == sim_lcd_violations())
+	{
+		printf("[SIM] LCD sin violaciones\n");
+		return;
+	}
+
+	printf("[SIM] FALLO LCD violaciones:");
+	for (index = 0; SIM_LCD_V_QTY > index; index++)
+	{
+		if (0 < sim_lcd_check.cnt[index])
+		{
+			printf(" %s %lu", sim_lcd_violation_name[index], (unsigned long)sim_lcd_check.cnt[index]);
+		}
+	}
+	printf("\n");
+}
+
+/********************** end of file ******************************************/
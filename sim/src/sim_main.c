@@ -0,0 +1,743 @@
+/*
+ * sim_main.c
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+/* Host simulation runner: replays a scenario script against Core/app.
+ *
+ * Usage: tdse_sim [-s cpu_scale] [-r dwt_read_cycles] [-t max_ms] scenario
+ *
+ * Scenario lines ("#" starts a comment), times in simulated mS:
+ *   <ms> pin    <NAME> <0|1>		drive an input (active low buttons/switches)
+ *   <ms> adc    <LM35|INTERNAL|channel> <0..4095>
+ *   <ms> expect <NAME> <0|1>		check an output level (LEDs are active low)
+ *   <ms> watch  <INPUT> <0|1> <OUTPUT> [max_us]
+ *								from now on, measure the latency from every
+ *								input change to that level up to the next
+ *								change of the output (fails above max_us)
+ *   <ms> i2c    <0|1>				connect or remove the LCD backpack (NACK)
+ *   <ms> lcd    <0|1> <text>		check that an LCD row starts with text (the
+ *								HD44780 model decodes GPIO and PCF8574 writes);
+ *								write |text| to keep its edge blanks
+ *
+ * Any HD44780 timing, busy or garbage-character violation fails the run, and
+ * so does a busy-flag read that drives 5 V into a pin that is not FT.
+ *   <ms> report					print the execution profile of every task
+ *   <ms> end						stop the simulation */
+
+/********************** inclusions *******************************************/
+#include <time.h>
+
+#include "main.h"
+#include "sim_lcd.h"
+
+/* Application & Tasks includes. */
+#include "board.h"
+#include "app.h"
+#include "display.h"
+#include "dwt.h"
+
+/********************** macros and definitions *******************************/
+#define SIM_EVENT_MAX			(256)
+#define SIM_LINE_MAXLEN			(128)
+#define SIM_MAX_MS_INI			(600000ul)
+#define SIM_WATCH_MAX			(8)
+#define SIM_CYCLES_PER_US		(SIM_CPU_HZ / 1000000ul)
+
+/********************** internal data declaration ****************************/
+typedef enum
+{
+	SIM_EV_PIN,
+	SIM_EV_ADC,
+	SIM_EV_EXPECT,
+	SIM_EV_WATCH,
+	SIM_EV_LCD,
+	SIM_EV_I2C,
+	SIM_EV_REPORT,
+	SIM_EV_END
+} sim_ev_t;
+
+typedef struct
+{
+	const char		*name;
+	GPIO_TypeDef	*port;
+	uint16_t		pin;
+	bool			input;
+} sim_pin_cfg_t;
+
+typedef struct
+{
+	uint32_t	ms;
+	sim_ev_t	event;
+	uint32_t	index;		// Pin index or ADC channel
+	uint32_t	value;
+	uint32_t	line;		// Line in the scenario file
+	uint32_t	output;		// Output pin index (watch)
+	uint32_t	limit_us;	// Latency limit, 0 = none (watch)
+	char		text[SIM_LCD_COLS + 1];	// Expected row prefix (lcd)
+} sim_event_t;
+
+typedef struct
+{
+	uint32_t	input;
+	uint32_t	level;
+	uint32_t	output;
+	uint32_t	limit_us;
+	bool		armed;
+	uint64_t	start;		// Simulated cycles at the input change
+	uint32_t	cnt;
+	uint64_t	min;
+	uint64_t	max;
+} sim_watch_t;
+
+/********************** internal data definition *****************************/
+static const sim_pin_cfg_t sim_pin_cfg_list[] = {
+	{"B1",				B1_GPIO_Port,		B1_Pin,				true},
+	{"SW_DESACTIVAR",	SW_DESACTIVAR_PORT,	SW_DESACTIVAR_PIN,	true},
+	{"SW_BARRERA",		SW_BARRERA_PORT,	SW_BARRERA_PIN,		true},
+	{"BTN_INGRESO",		BTN_INGRESO_PORT,	BTN_INGRESO_PIN,	true},
+	{"BTN_EGRESO",		BTN_EGRESO_PORT,	BTN_EGRESO_PIN,		true},
+	{"BTN_MODE",		BTN_MODE_PORT,		BTN_MODE_PIN,		true},
+	{"BTN_ENTER",		BTN_ENTER_PORT,		BTN_ENTER_PIN,		true},
+	{"BTN_ACTIVE",		BTN_ACTIVE_PORT,	BTN_ACTIVE_PIN,		true},
+	{"LCD_SDA",			LCD_I2C_SDA_PORT,	LCD_I2C_SDA_PIN,	true},	// 0 = held low by a slave
+	{"LED_MOTOR_MAX",	LED_MOTOR_MAX_PORT,	LED_MOTOR_MAX_PIN,	false},
+	{"LED_MOTOR_MIN",	LED_MOTOR_MIN_PORT,	LED_MOTOR_MIN_PIN,	false},
+	{"LED_SYSTEM",		LED_SYSTEM_PORT,	LED_SYSTEM_PIN,		false},
+	{"LED_ALERT",		LED_ALERT_PORT,		LED_ALERT_PIN,		false},
+	{"BUZZER",			BUZZER_PORT,		BUZZER_PIN,			false}
+};
+
+#define SIM_PIN_QTY		(sizeof(sim_pin_cfg_list)/sizeof(sim_pin_cfg_t))
+
+/* LCD data bus D0..D7 (bit n of sim_lcd_bus() data) */
+static const struct
+{
+	GPIO_TypeDef	*port;
+	uint16_t		pin;
+} sim_lcd_data_list[] = {
+	{LCD_D0_PORT, LCD_D0_PIN}, {LCD_D1_PORT, LCD_D1_PIN}, {LCD_D2_PORT, LCD_D2_PIN}, {LCD_D3_PORT, LCD_D3_PIN},
+	{LCD_D4_PORT, LCD_D4_PIN}, {LCD_D5_PORT, LCD_D5_PIN}, {LCD_D6_PORT, LCD_D6_PIN}, {LCD_D7_PORT, LCD_D7_PIN},
+};
+
+#define SIM_LCD_DATA_QTY	(sizeof(sim_lcd_data_list)/sizeof(sim_lcd_data_list[0]))
+
+/* STM32F103 pins that are not 5 V tolerant (no FT in the datasheet pinout):
+ * the 5 V HD44780 may only drive a high level into FT pins */
+#define SIM_NOT_FT_PA	0x00FFu		// PA0..PA7
+#define SIM_NOT_FT_PB	0x0023u		// PB0, PB1, PB5
+#define SIM_NOT_FT_PC	0xE03Fu		// PC0..PC5, PC13..PC15
+
+static sim_event_t sim_event_list[SIM_EVENT_MAX];
+static uint32_t sim_event_qty;
+static uint32_t sim_event_idx;
+static uint32_t sim_expect_ok;
+static uint32_t sim_expect_fail;
+static uint32_t sim_ft_fail;
+static bool sim_i2c_present = true;
+static sim_watch_t sim_watch_list[SIM_WATCH_MAX];
+static uint32_t sim_watch_qty;
+static bool sim_report_req;
+static bool sim_end;
+
+/********************** external data declaration ****************************/
+ADC_HandleTypeDef hadc1;
+
+/********************** internal functions definition ************************/
+static int sim_pin_find(const char *p_name)
+{
+	uint32_t index;
+
+	for (index = 0; SIM_PIN_QTY > index; index++)
+	{
+		if (0 == strcmp(p_name, sim_pin_cfg_list[index].name))
+		{
+			return (int)index;
+		}
+	}
+
+	return -1;
+}
+
+static bool sim_scenario_error(FILE *p_file, const char *p_path, uint32_t line, const char *p_msg)
+{
+	fprintf(stderr, "[SIM] %s:%lu: %s\n", p_path, (unsigned long)line, p_msg);
+	fclose(p_file);
+
+	return false;
+}
+
+static bool sim_scenario_load(const char *p_path)
+{
+	FILE *p_file;
+	char line[SIM_LINE_MAXLEN];
+	char cmd[16];
+	char arg[3][32];
+	unsigned long ms;
+	uint32_t line_cnt = 0;
+	uint32_t ms_last = 0;
+	sim_event_t *p_ev;
+	int fields;
+	int pin;
+	int output;
+	int offset;
+	size_t len;
+
+	p_file = fopen(p_path, "r");
+	if (NULL == p_file)
+	{
+		fprintf(stderr, "[SIM] no se puede abrir %s\n", p_path);
+		return false;
+	}
+
+	while (NULL != fgets(line, sizeof(line), p_file))
+	{
+		line_cnt++;
+		line[strcspn(line, "#\r\n")] = '\0';
+
+		fields = sscanf(line, "%lu %15s %31s %31s %31s", &ms, cmd, arg[0], arg[1], arg[2]);
+		if (0 >= fields)
+		{
+			continue;
+		}
+
+		if ((2 > fields) || (SIM_EVENT_MAX <= sim_event_qty) || (ms_last > ms))
+		{
+			return sim_scenario_error(p_file, p_path, line_cnt, "linea invalida o fuera de orden");
+		}
+
+		p_ev = &sim_event_list[sim_event_qty];
+		p_ev->ms = (uint32_t)ms;
+		p_ev->line = line_cnt;
+		ms_last = (uint32_t)ms;
+
+		if ((0 == strcmp(cmd, "pin")) || (0 == strcmp(cmd, "expect")))
+		{
+			pin = (4 == fields) ? sim_pin_find(arg[0]) : -1;
+			if ((0 > pin) || (sim_pin_cfg_list[pin].input != (0 == strcmp(cmd, "pin"))))
+			{
+				return sim_scenario_error(p_file, p_path, line_cnt, "pin desconocido");
+			}
+			p_ev->event = (0 == strcmp(cmd, "pin")) ? SIM_EV_PIN : SIM_EV_EXPECT;
+			p_ev->index = (uint32_t)pin;
+			p_ev->value = (0 != strtoul(arg[1], NULL, 0)) ? 1ul : 0ul;
+		}
+		else if ((0 == strcmp(cmd, "watch")) && (5 <= fields))
+		{
+			pin = sim_pin_find(arg[0]);
+			output = sim_pin_find(arg[2]);
+			if ((0 > pin) || (0 > output) || !sim_pin_cfg_list[pin].input || sim_pin_cfg_list[output].input)
+			{
+				return sim_scenario_error(p_file, p_path, line_cnt, "pin desconocido");
+			}
+			p_ev->event = SIM_EV_WATCH;
+			p_ev->index = (uint32_t)pin;
+			p_ev->value = (0 != strtoul(arg[1], NULL, 0)) ? 1ul : 0ul;
+			p_ev->output = (uint32_t)output;
+			p_ev->limit_us = 0;
+			if (1 == sscanf(line, "%*u %*s %*s %*s %*s %lu", &ms))
+			{
+				p_ev->limit_us = (uint32_t)ms;
+			}
+		}
+		else if ((0 == strcmp(cmd, "i2c")) && (3 == fields))
+		{
+			p_ev->event = SIM_EV_I2C;
+			p_ev->value = (0 != strtoul(arg[0], NULL, 0)) ? 1ul : 0ul;
+		}
+		else if ((0 == strcmp(cmd, "adc")) && (4 == fields))
+		{
+			p_ev->event = SIM_EV_ADC;
+			if (0 == strcmp(arg[0], "LM35"))
+			{
+				p_ev->index = ADC_LM35_CHANNEL;
+			}
+			else if (0 == strcmp(arg[0], "INTERNAL"))
+			{
+				p_ev->index = ADC_INTERNAL_CHANNEL;
+			}
+			else
+			{
+				p_ev->index = (uint32_t)strtoul(arg[0], NULL, 0);
+			}
+			p_ev->value = (uint32_t)strtoul(arg[1], NULL, 0);
+		}
+		else if ((0 == strcmp(cmd, "lcd")) && (4 <= fields))
+		{
+			/* The text is the rest of the line, trailing blanks removed;
+			 * |text| keeps its leading and trailing blanks */
+			offset = 0;
+			(void)sscanf(line, "%*u %*s %*s %n", &offset);
+			len = strlen(&line[offset]);
+			while ((0 < len) && (' ' == line[offset + len - 1]))
+			{
+				len--;
+			}
+			if ((2 <= len) && ('|' == line[offset]) && ('|' == line[offset + len - 1]))
+			{
+				offset++;
+				len -= 2;
+			}
+			if ((0 == offset) || (SIM_LCD_COLS < len))
+			{
+				return sim_scenario_error(p_file, p_path, line_cnt, "texto de LCD invalido");
+			}
+			p_ev->event = SIM_EV_LCD;
+			p_ev->index = (0 != strtoul(arg[0], NULL, 0)) ? 1ul : 0ul;
+			memcpy(p_ev->text, &line[offset], len);
+			p_ev->text[len] = '\0';
+		}
+		else if (0 == strcmp(cmd, "report"))
+		{
+			p_ev->event = SIM_EV_REPORT;
+		}
+		else if (0 == strcmp(cmd, "end"))
+		{
+			p_ev->event = SIM_EV_END;
+		}
+		else
+		{
+			return sim_scenario_error(p_file, p_path, line_cnt, "comando desconocido");
+		}
+
+		sim_event_qty++;
+	}
+
+	fclose(p_file);
+
+	return true;
+}
+
+/* Arm the watches of an input that just changed to their level */
+static void sim_watch_input(uint32_t input, uint32_t level)
+{
+	uint32_t index;
+	sim_watch_t *p_watch;
+
+	for (index = 0; sim_watch_qty > index; index++)
+	{
+		p_watch = &sim_watch_list[index];
+
+		if ((input == p_watch->input) && (level == p_watch->level) && !p_watch->armed)
+		{
+			p_watch->armed = true;
+			p_watch->start = sim_cycles();
+		}
+	}
+}
+
+/* CNF/MODE of a pin: MODE = 00 is an input */
+static bool sim_pin_is_input(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin)
+{
+	uint32_t pin = 31ul - __CLZ(GPIO_Pin);
+	uint32_t cr = (8 > pin) ? GPIOx->CRL : GPIOx->CRH;
+
+	return (0 == ((cr >> ((pin & 7ul) * 4ul)) & 0x3ul));
+}
+
+static bool sim_pin_is_ft(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin)
+{
+	uint16_t not_ft = 0;
+
+	if (GPIOA == GPIOx)
+	{
+		not_ft = SIM_NOT_FT_PA;
+	}
+	else if (GPIOB == GPIOx)
+	{
+		not_ft = SIM_NOT_FT_PB;
+	}
+	else if (GPIOC == GPIOx)
+	{
+		not_ft = SIM_NOT_FT_PC;
+	}
+
+	return (0 == (not_ft & GPIO_Pin));
+}
+
+/* Called by the simulator when an output register changes */
+static void sim_gpio_change(GPIO_TypeDef *GPIOx, uint32_t odr_old, uint32_t odr_new)
+{
+	uint32_t index;
+	uint64_t latency;
+	uint8_t input;
+	uint8_t data;
+	sim_watch_t *p_watch;
+	const sim_pin_cfg_t *p_pin;
+
+	/* LCD bus on GPIO (4-bit and 8-bit backends, D0..D3 stay low in 4-bit) */
+	if ((LCD_RS_PORT == GPIOx) || (LCD_RW_PORT == GPIOx) || (LCD_EN_PORT == GPIOx) ||
+		(LCD_D0_PORT == GPIOx) || (LCD_D1_PORT == GPIOx) || (LCD_D2_PORT == GPIOx) || (LCD_D3_PORT == GPIOx) ||
+		(LCD_D4_PORT == GPIOx) || (LCD_D5_PORT == GPIOx) || (LCD_D6_PORT == GPIOx) || (LCD_D7_PORT == GPIOx))
+	{
+		for (index = 0, input = 0; SIM_LCD_DATA_QTY > index; index++)
+		{
+			if (sim_pin_is_input(sim_lcd_data_list[index].port, sim_lcd_data_list[index].pin))
+			{
+				input |= (uint8_t)(1u << index);
+			}
+		}
+
+		sim_lcd_bus(0 != (LCD_RS_PORT->ODR & LCD_RS_PIN), 0 != (LCD_RW_PORT->ODR & LCD_RW_PIN),
+					0 != (LCD_EN_PORT->ODR & LCD_EN_PIN),
+					(uint8_t)(((0 != (LCD_D0_PORT->ODR & LCD_D0_PIN)) ? 0x01 : 0) |
+							  ((0 != (LCD_D1_PORT->ODR & LCD_D1_PIN)) ? 0x02 : 0) |
+							  ((0 != (LCD_D2_PORT->ODR & LCD_D2_PIN)) ? 0x04 : 0) |
+							  ((0 != (LCD_D3_PORT->ODR & LCD_D3_PIN)) ? 0x08 : 0) |
+							  ((0 != (LCD_D4_PORT->ODR & LCD_D4_PIN)) ? 0x10 : 0) |
+							  ((0 != (LCD_D5_PORT->ODR & LCD_D5_PIN)) ? 0x20 : 0) |
+							  ((0 != (LCD_D6_PORT->ODR & LCD_D6_PIN)) ? 0x40 : 0) |
+							  ((0 != (LCD_D7_PORT->ODR & LCD_D7_PIN)) ? 0x80 : 0)),
+					input);
+
+		/* Busy flag read (DISPLAY_CFG_BUSY_FLAG): the LCD drives the input pins */
+		if ((0 != (LCD_RW_PORT->ODR & LCD_RW_PIN)) && (0 != (LCD_EN_PORT->ODR & LCD_EN_PIN)))
+		{
+			data = sim_lcd_read();
+			for (index = 0; SIM_LCD_DATA_QTY > index; index++)
+			{
+				if (input & (1u << index))
+				{
+					if (data & (1u << index))
+					{
+						sim_lcd_data_list[index].port->IDR |= sim_lcd_data_list[index].pin;
+						if (!sim_pin_is_ft(sim_lcd_data_list[index].port, sim_lcd_data_list[index].pin))
+						{
+							if (0 == sim_ft_fail)
+							{
+								fprintf(stderr, "[SIM] FALLO el LCD pone 5 V en D%lu (pin no FT)\n",
+										(unsigned long)index);
+							}
+							sim_ft_fail++;
+						}
+					}
+					else
+					{
+						sim_lcd_data_list[index].port->IDR &= ~(uint32_t)sim_lcd_data_list[index].pin;
+					}
+				}
+			}
+		}
+	}
+
+	for (index = 0; sim_watch_qty > index; index++)
+	{
+		p_watch = &sim_watch_list[index];
+		p_pin = &sim_pin_cfg_list[p_watch->output];
+
+		if (p_watch->armed && (GPIOx == p_pin->port) && ((odr_old ^ odr_new) & p_pin->pin))
+		{
+			latency = sim_cycles() - p_watch->start;
+			p_watch->armed = false;
+			p_watch->cnt++;
+			if ((1 == p_watch->cnt) || (p_watch->min > latency))
+			{
+				p_watch->min = latency;
+			}
+			if (p_watch->max < latency)
+			{
+				p_watch->max = latency;
+			}
+		}
+	}
+}
+
+/* Called by the simulator for every I2C byte: the only slave is the LCD backpack */
+static bool sim_i2c_write(uint8_t addr, int32_t byte)
+{
+	if (SIM_I2C_HOOK_START == byte)
+	{
+		return (0 != (LCD_I2C_SDA_PORT->IDR & LCD_I2C_SDA_PIN));
+	}
+
+	if (!sim_i2c_present || (LCD_I2C_ADDR != addr))
+	{
+		return false;
+	}
+
+	if (0 <= byte)
+	{
+		sim_lcd_pcf8574_write((uint8_t)byte);
+	}
+
+	return true;
+}
+
+static void sim_watch_log(void)
+{
+	uint32_t index;
+	const sim_watch_t *p_watch;
+
+	for (index = 0; sim_watch_qty > index; index++)
+	{
+		p_watch = &sim_watch_list[index];
+
+		printf("[SIM] latencia %s=%lu -> %s: %lu flancos, min %lu us, max %lu us\n",
+			   sim_pin_cfg_list[p_watch->input].name, (unsigned long)p_watch->level,
+			   sim_pin_cfg_list[p_watch->output].name, (unsigned long)p_watch->cnt,
+			   (unsigned long)(p_watch->min / SIM_CYCLES_PER_US),
+			   (unsigned long)(p_watch->max / SIM_CYCLES_PER_US));
+
+		if ((0 < p_watch->limit_us) && ((0 == p_watch->cnt) || p_watch->armed ||
+			((p_watch->max / SIM_CYCLES_PER_US) > p_watch->limit_us)))
+		{
+			sim_expect_fail++;
+			fprintf(stderr, "[SIM] FALLO latencia %s -> %s: limite %lu us\n",
+					sim_pin_cfg_list[p_watch->input].name, sim_pin_cfg_list[p_watch->output].name,
+					(unsigned long)p_watch->limit_us);
+		}
+	}
+}
+
+/* Called by the simulator on every tick, before SysTick is taken */
+static void sim_scenario_tick(uint32_t ms)
+{
+	const sim_event_t *p_ev;
+	const sim_pin_cfg_t *p_pin;
+	GPIO_PinState level;
+	char text[SIM_LCD_COLS + 1];
+
+	while ((sim_event_qty > sim_event_idx) && (ms >= sim_event_list[sim_event_idx].ms))
+	{
+		p_ev = &sim_event_list[sim_event_idx++];
+		p_pin = &sim_pin_cfg_list[p_ev->index];
+
+		switch (p_ev->event)
+		{
+			case SIM_EV_PIN:
+				if (p_ev->value != ((p_pin->port->IDR & p_pin->pin) ? 1ul : 0ul))
+				{
+					sim_watch_input(p_ev->index, p_ev->value);
+				}
+				sim_pin_set(p_pin->port, p_pin->pin, p_ev->value ? GPIO_PIN_SET : GPIO_PIN_RESET);
+				break;
+
+			case SIM_EV_WATCH:
+				if (SIM_WATCH_MAX > sim_watch_qty)
+				{
+					sim_watch_list[sim_watch_qty].input = p_ev->index;
+					sim_watch_list[sim_watch_qty].level = p_ev->value;
+					sim_watch_list[sim_watch_qty].output = p_ev->output;
+					sim_watch_list[sim_watch_qty].limit_us = p_ev->limit_us;
+					sim_watch_qty++;
+				}
+				break;
+
+			case SIM_EV_ADC:
+				sim_adc_set(p_ev->index, p_ev->value);
+				break;
+
+			case SIM_EV_EXPECT:
+				level = sim_pin_get(p_pin->port, p_pin->pin);
+				if ((uint32_t)level == p_ev->value)
+				{
+					sim_expect_ok++;
+				}
+				else
+				{
+					sim_expect_fail++;
+					fprintf(stderr, "[SIM] FALLO linea %lu, t = %lu ms: %s = %u (esperado %lu)\n",
+							(unsigned long)p_ev->line, (unsigned long)ms, p_pin->name,
+							(unsigned)level, (unsigned long)p_ev->value);
+				}
+				break;
+
+			case SIM_EV_LCD:
+				sim_lcd_row(p_ev->index, text);
+				if (0 == strncmp(text, p_ev->text, strlen(p_ev->text)))
+				{
+					sim_expect_ok++;
+				}
+				else
+				{
+					sim_expect_fail++;
+					fprintf(stderr, "[SIM] FALLO linea %lu, t = %lu ms: LCD %lu = |%s| (esperado |%s|)\n",
+							(unsigned long)p_ev->line, (unsigned long)ms, (unsigned long)p_ev->index,
+							text, p_ev->text);
+				}
+				break;
+
+			case SIM_EV_I2C:
+				sim_i2c_present = (0 != p_ev->value);
+				break;
+
+			case SIM_EV_REPORT:
+				sim_report_req = true;
+				break;
+
+			case SIM_EV_END:
+				sim_end = true;
+				break;
+
+			default:
+				break;
+		}
+	}
+
+	if (sim_event_qty <= sim_event_idx)
+	{
+		sim_end = true;
+	}
+}
+
+/* Reset state of the pins, as left by MX_GPIO_Init() */
+static void sim_gpio_init(void)
+{
+	uint32_t index;
+	GPIO_InitTypeDef GPIO_InitStruct = {0};
+
+	for (index = 0; SIM_GPIO_PORT_QTY > index; index++)
+	{
+		sim_gpio[index].CRL = GPIO_CR_RESET;
+		sim_gpio[index].CRH = GPIO_CR_RESET;
+	}
+
+	/* Outputs: LEDs/buzzer at low speed, LCD RS/EN/D4..D7 at high speed */
+	GPIO_InitStruct.Mode = GPIO_MODE_OUTPUT_PP;
+	GPIO_InitStruct.Pull = GPIO_NOPULL;
+	GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_LOW;
+	for (index = 0; SIM_PIN_QTY > index; index++)
+	{
+		if (!sim_pin_cfg_list[index].input)
+		{
+			GPIO_InitStruct.Pin = sim_pin_cfg_list[index].pin;
+			HAL_GPIO_Init(sim_pin_cfg_list[index].port, &GPIO_InitStruct);
+		}
+	}
+	GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_HIGH;
+	GPIO_InitStruct.Pin = LCD_RS_PIN;
+	HAL_GPIO_Init(LCD_RS_PORT, &GPIO_InitStruct);
+	GPIO_InitStruct.Pin = LCD_EN_PIN;
+	HAL_GPIO_Init(LCD_EN_PORT, &GPIO_InitStruct);
+	for (index = 4; SIM_LCD_DATA_QTY > index; index++)
+	{
+		GPIO_InitStruct.Pin = sim_lcd_data_list[index].pin;
+		HAL_GPIO_Init(sim_lcd_data_list[index].port, &GPIO_InitStruct);
+	}
+
+	for (index = 0; SIM_PIN_QTY > index; index++)
+	{
+		if (sim_pin_cfg_list[index].input)
+		{
+			/* Pull-up: released buttons and open switches read high */
+			sim_pin_set(sim_pin_cfg_list[index].port, sim_pin_cfg_list[index].pin, GPIO_PIN_SET);
+		}
+	}
+
+	/* Same EXTI lines as MX_GPIO_Init() */
+	sim_exti_falling_enable(SW_DESACTIVAR_GPIO_Port, SW_DESACTIVAR_Pin);
+	sim_exti_falling_enable(B1_GPIO_Port, B1_Pin);
+}
+
+static uint64_t sim_host_ms(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return ((uint64_t)ts.tv_sec * 1000ull) + ((uint64_t)ts.tv_nsec / 1000000ull);
+}
+
+/********************** external functions definition ************************/
+/* PendSV_Handler() of Core/Src/stm32f1xx_it.c */
+void PendSV_Handler(void)
+{
+	app_fg_update();
+}
+
+/* EXTI0_IRQHandler() of Core/Src/stm32f1xx_it.c */
+void EXTI0_IRQHandler(void)
+{
+	g_app_exti0_cyc = cycle_counter_get();
+	HAL_GPIO_EXTI_Callback(SW_DESACTIVAR_Pin);
+}
+
+/* I2C2_EV_IRQHandler() / I2C2_ER_IRQHandler() of Core/Src/stm32f1xx_it.c */
+void I2C2_EV_IRQHandler(void)
+{
+	displayI2cEventIrq();
+}
+
+void I2C2_ER_IRQHandler(void)
+{
+	displayI2cErrorIrq();
+}
+
+void Error_Handler(void)
+{
+	fprintf(stderr, "[SIM] Error_Handler()\n");
+	exit(2);
+}
+
+int main(int argc, char *argv[])
+{
+	sim_cfg_t cfg = { 1.0, SIM_DWT_READ_CYC_INI, sim_scenario_tick, sim_gpio_change, sim_i2c_write };
+	unsigned long max_ms = SIM_MAX_MS_INI;
+	const char *p_path = NULL;
+	uint64_t host_start_ms;
+	uint64_t host_ms;
+	int index;
+
+	for (index = 1; argc > index; index++)
+	{
+		if ((0 == strcmp(argv[index], "-s")) && (argc > (index + 1)))
+		{
+			cfg.cpu_scale = strtod(argv[++index], NULL);
+		}
+		else if ((0 == strcmp(argv[index], "-r")) && (argc > (index + 1)))
+		{
+			cfg.dwt_read_cycles = (uint32_t)strtoul(argv[++index], NULL, 0);
+		}
+		else if ((0 == strcmp(argv[index], "-t")) && (argc > (index + 1)))
+		{
+			max_ms = strtoul(argv[++index], NULL, 0);
+		}
+		else
+		{
+			p_path = argv[index];
+		}
+	}
+
+	if ((NULL == p_path) || !sim_scenario_load(p_path))
+	{
+		fprintf(stderr, "uso: %s [-s cpu_scale] [-r dwt_read_cycles] [-t max_ms] escenario\n", argv[0]);
+		return 2;
+	}
+
+	host_start_ms = sim_host_ms();
+
+	sim_init(&cfg);
+	sim_lcd_init();
+	HAL_Init();
+	sim_gpio_init();
+
+	app_init();
+
+	while (!sim_end && (max_ms > sim_time_ms()))
+	{
+		app_update();
+
+		if (sim_report_req)
+		{
+			sim_report_req = false;
+			app_log_profile();
+		}
+	}
+
+	app_log_profile();
+	sim_watch_log();
+	sim_lcd_log();
+	sim_expect_fail += sim_lcd_violations() + sim_ft_fail;
+
+	host_ms = sim_host_ms() - host_start_ms;
+
+	printf("[SIM] %s: %lu ms simulados en %lu ms (x%lu), expect %lu ok / %lu fallos\n",
+		   p_path, (unsigned long)sim_time_ms(), (unsigned long)host_ms,
+		   (unsigned long)(sim_time_ms() / ((0 < host_ms) ? host_ms : 1)),
+		   (unsigned long)sim_expect_ok, (unsigned long)sim_expect_fail);
+
+	return (0 == sim_expect_fail) ? 0 : 1;
+}
+
+/********************** end of file ******************************************/